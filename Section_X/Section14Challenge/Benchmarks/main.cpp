@@ -0,0 +1,442 @@
+// Section 14
+// Mystring benchmarks
+//
+// Build from this folder with:
+//      g++ -std=c++17 -O2 -Wall -pthread -I../MemberFunctions main.cpp $(ls ../MemberFunctions/*.cpp | grep -v main.cpp) -o main
+// Add -mavx2 (or -march=native) to use the AVX2 case conversion kernel instead of SSE2
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <map>
+#include <unordered_map>
+#include "Mystring.h"
+#include "Mystring_Intern.h"
+#include "Mystring_Rope.h"
+
+using namespace std;
+
+// Every heap allocation in the program goes through these, so we can count them (atomically: the
+// threaded benchmarks allocate from several threads at once)
+static atomic<size_t> allocation_count {0};
+
+void *operator new(size_t size) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    if (void *p = malloc(size))
+        return p;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+constexpr size_t iterations {1'000'000};
+
+// Constructs (and destroys) a Mystring from text `iterations` times and reports the heap traffic
+void bench_constructions(const char *label, const char *text) {
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    size_t total_length {0};
+    for (size_t i = 0; i < iterations; i++) {
+        Mystring s {text};
+        total_length += s.get_length();
+    }
+    auto stop = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(stop - start).count();
+    cout << setw(28) << left << label
+         << setw(12) << right << (allocation_count - before) << " allocations"
+         << setw(10) << fixed << setprecision(1) << ms << " ms"
+         << "   (" << total_length << " chars)" << endl;
+}
+
+// Builds one long string with += and reports how many times the buffer had to grow
+void bench_appends(size_t count) {
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    Mystring s;
+    Mystring piece {"x"};
+    for (size_t i = 0; i < count; i++)
+        s += piece;
+    auto stop = chrono::steady_clock::now();
+    size_t allocations = allocation_count - before;
+    double ms = chrono::duration<double, milli>(stop - start).count();
+    cout << setw(28) << left << ("+= of " + to_string(count) + " chars")
+         << setw(12) << right << allocations << " allocations"
+         << setw(10) << fixed << setprecision(1) << ms << " ms"
+         << "   (length " << s.get_length() << ", capacity " << s.get_capacity() << ")" << endl;
+}
+
+// Times "abc" * n; with one allocation and doubling copies the time should grow linearly with n
+void bench_repeat(int n) {
+    Mystring unit {"abc"};
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    Mystring s = unit * n;
+    auto stop = chrono::steady_clock::now();
+    size_t allocations = allocation_count - before;
+    double ms = chrono::duration<double, milli>(stop - start).count();
+    cout << setw(28) << left << ("\"abc\" * " + to_string(n))
+         << setw(12) << right << allocations << " allocations"
+         << setw(10) << fixed << setprecision(3) << ms << " ms"
+         << "   (" << (ms * 1'000'000.0 / s.get_length()) << " ns/char)" << endl;
+}
+
+// Lowercases a long mixed-case string in place and compares against a plain tolower loop
+void bench_lowercase(size_t len) {
+    Mystring unit {"Romeo And Juliet, ACT I. "};
+    Mystring s = unit * static_cast<int>(len / unit.get_length());
+    Mystring reference {s};
+
+    auto start = chrono::steady_clock::now();
+    char *ref = const_cast<char *>(reference.get_str());
+    for (int i = 0; i < reference.get_length(); i++)
+        ref[i] = static_cast<char>(tolower(static_cast<unsigned char>(ref[i])));
+    auto middle = chrono::steady_clock::now();
+    s.to_lower();
+    auto stop = chrono::steady_clock::now();
+
+    double scalar_ms = chrono::duration<double, milli>(middle - start).count();
+    double kernel_ms = chrono::duration<double, milli>(stop - middle).count();
+    cout << setw(28) << left << ("to_lower() " + to_string(s.get_length() / 1'000'000) + "M chars")
+         << right << fixed << setprecision(2)
+         << "tolower loop " << scalar_ms << " ms, kernel " << kernel_ms << " ms"
+         << (s == reference ? "" : "   ** MISMATCH **") << endl;
+}
+
+// Sorts and dedupes a batch of random short keys - dominated by operator< and operator==
+void bench_sort_dedupe(size_t count) {
+    mt19937 rng {42};
+    uniform_int_distribution<int> letter {'a', 'z'};
+    uniform_int_distribution<int> key_length {3, 12};
+    vector<Mystring> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        char buff[16] {};
+        int n = key_length(rng);
+        for (int j = 0; j < n; j++)
+            buff[j] = static_cast<char>(letter(rng));
+        keys.emplace_back(buff);
+    }
+
+    auto start = chrono::steady_clock::now();
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    auto stop = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(stop - start).count();
+    cout << setw(28) << left << ("sort + dedupe " + to_string(count) + " keys")
+         << right << fixed << setprecision(1) << ms << " ms   (" << keys.size() << " unique)" << endl;
+}
+
+// Tokenizes the same text three ways; text is held in memory so only the parsing is timed
+void bench_extraction(const string &text, int passes) {
+    size_t words {0};
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < passes; i++) {
+        istringstream in {text};
+        string word;
+        while (in >> word)
+            words++;
+    }
+    auto t1 = chrono::steady_clock::now();
+    size_t string_allocations = allocation_count - before;
+
+    before = allocation_count;
+    for (int i = 0; i < passes; i++) {
+        istringstream in {text};
+        Mystring word;
+        while (in >> word)
+            words++;
+    }
+    auto t2 = chrono::steady_clock::now();
+    size_t mystring_allocations = allocation_count - before;
+
+    before = allocation_count;
+    for (int i = 0; i < passes; i++) {
+        istringstream in {text};
+        words += Mystring::read_words(in).size();
+    }
+    auto t3 = chrono::steady_clock::now();
+    size_t bulk_allocations = allocation_count - before;
+
+    double mb = static_cast<double>(text.size()) * passes / (1024.0 * 1024.0);
+    auto report = [mb](const char *label, chrono::steady_clock::time_point from,
+                       chrono::steady_clock::time_point to, size_t allocations) {
+        double seconds = chrono::duration<double>(to - from).count();
+        cout << setw(28) << left << label << right << fixed << setprecision(1)
+             << setw(8) << mb / seconds << " MB/s" << setw(12) << allocations << " allocations" << endl;
+    };
+    report("std::string >>", start, t1, string_allocations);
+    report("Mystring >>", t1, t2, mystring_allocations);
+    report("Mystring::read_words", t2, t3, bulk_allocations);
+    cout << "(" << words / 3 << " words)" << endl;
+}
+
+// Builds a batch of medium-length strings, then throws the whole batch away - repeated `rounds` times
+void bench_batch(size_t batch_size, int rounds) {
+    const char *samples[] {
+        "Two households, both alike in dignity",
+        "In fair Verona, where we lay our scene",
+        "From ancient grudge break to new mutiny",
+        "Where civil blood makes civil hands unclean"
+    };
+
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        vector<Mystring> batch;
+        batch.reserve(batch_size);
+        for (size_t i = 0; i < batch_size; i++)
+            batch.emplace_back(samples[i % 4]);
+    }
+    auto t1 = chrono::steady_clock::now();
+    size_t heap_allocations = allocation_count - before;
+
+    before = allocation_count;
+    Mystring_Arena arena;
+    for (int r = 0; r < rounds; r++) {
+        {
+            vector<Mystring> batch;
+            batch.reserve(batch_size);
+            for (size_t i = 0; i < batch_size; i++)
+                batch.emplace_back(samples[i % 4], arena);
+        }
+        arena.reset();
+    }
+    auto t2 = chrono::steady_clock::now();
+    size_t arena_allocations = allocation_count - before;
+
+    cout << setw(28) << left << "heap" << right << fixed << setprecision(1)
+         << setw(8) << chrono::duration<double, milli>(t1 - start).count() << " ms"
+         << setw(12) << heap_allocations << " allocations" << endl;
+    cout << setw(28) << left << "arena + reset()" << right
+         << setw(8) << chrono::duration<double, milli>(t2 - t1).count() << " ms"
+         << setw(12) << arena_allocations << " allocations" << endl;
+}
+
+// Compares against a literal longer than the inline buffer, first through a temporary Mystring, then through a view
+void bench_literal_compare() {
+    Mystring title {"Romeo and Juliet, a tragedy"};
+    size_t matches {0};
+
+    size_t before = allocation_count;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        matches += (Mystring{"Romeo and Juliet, a tragedy"} == title);
+    auto t1 = chrono::steady_clock::now();
+    size_t temporary_allocations = allocation_count - before;
+
+    before = allocation_count;
+    for (size_t i = 0; i < iterations; i++)
+        matches += ("Romeo and Juliet, a tragedy" == title);
+    auto t2 = chrono::steady_clock::now();
+    size_t view_allocations = allocation_count - before;
+
+    cout << setw(28) << left << "Mystring{\"...\"} == s" << right << fixed << setprecision(1)
+         << setw(8) << chrono::duration<double, milli>(t1 - start).count() << " ms"
+         << setw(12) << temporary_allocations << " allocations" << endl;
+    cout << setw(28) << left << "\"...\" == s (view)" << right
+         << setw(8) << chrono::duration<double, milli>(t2 - t1).count() << " ms"
+         << setw(12) << view_allocations << " allocations"
+         << "   (" << matches << " matches)" << endl;
+}
+
+// Interns every word of the text from several threads at once, then compares handles vs strings
+void bench_interning(const string &text, int threads) {
+    istringstream in {text};
+    vector<Mystring> words = Mystring::read_words(in);
+    Mystring_Intern_Table table;
+
+    auto start = chrono::steady_clock::now();
+    vector<vector<Interned_Mystring>> handles(threads);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            handles[t].reserve(words.size());
+            for (const Mystring &word : words)
+                handles[t].push_back(table.intern(word));
+        });
+    }
+    for (thread &worker : workers)
+        worker.join();
+    auto t1 = chrono::steady_clock::now();
+
+    // Count how often each word equals its neighbour - once with strings, once with handles
+    size_t string_equal {0};
+    size_t handle_equal {0};
+    for (int pass = 0; pass < 20; pass++)
+        for (size_t i = 1; i < words.size(); i++)
+            string_equal += (words[i] == words[i - 1]);
+    auto t2 = chrono::steady_clock::now();
+    const vector<Interned_Mystring> &h = handles[0];
+    for (int pass = 0; pass < 20; pass++)
+        for (size_t i = 1; i < h.size(); i++)
+            handle_equal += (h[i] == h[i - 1]);
+    auto t3 = chrono::steady_clock::now();
+
+    cout << threads << " threads interned " << threads * words.size() << " words in " << fixed << setprecision(1)
+         << chrono::duration<double, milli>(t1 - start).count() << " ms: "
+         << table.get_size() << " unique, hit rate " << setprecision(2) << 100.0 * table.get_hit_rate() << "%, "
+         << table.get_bytes_saved() / 1024 << " KiB saved" << endl;
+    cout << setw(28) << left << "Mystring ==" << right << setprecision(1)
+         << setw(8) << chrono::duration<double, milli>(t2 - t1).count() << " ms   (" << string_equal << " equal)" << endl;
+    cout << setw(28) << left << "Interned_Mystring ==" << right
+         << setw(8) << chrono::duration<double, milli>(t3 - t2).count() << " ms   (" << handle_equal << " equal)" << endl;
+}
+
+// Builds a document of total_size chars from 100-char pieces, flat Mystring vs Mystring_Rope
+// Appends are amortized O(1) for both; prepends and middle inserts are where the flat string goes quadratic,
+// so the flat versions of those are only run up to flat_limit chars, and random middle inserts
+// (which cut a chunk every time) build a tenth of the document
+void bench_rope(size_t total_size, size_t flat_limit) {
+    Mystring piece = Mystring{"0123456789"} * 10;
+    size_t pieces = total_size / piece.get_length();
+    size_t flat_pieces = flat_limit / piece.get_length();
+    auto ms_since = [](chrono::steady_clock::time_point from) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - from).count();
+    };
+    auto report = [](const string &label, double ms, size_t length) {
+        cout << setw(36) << left << label << right << fixed << setprecision(1)
+             << setw(10) << ms << " ms   (" << length / (1024.0 * 1024.0) << " MiB)" << endl;
+    };
+
+    auto start = chrono::steady_clock::now();
+    Mystring flat;
+    for (size_t i = 0; i < pieces; i++)
+        flat += piece;
+    report("flat append", ms_since(start), flat.get_length());
+    flat = Mystring{};
+
+    start = chrono::steady_clock::now();
+    Mystring_Rope rope;
+    for (size_t i = 0; i < pieces; i++)
+        rope.append(piece);
+    report("rope append", ms_since(start), rope.get_length());
+    start = chrono::steady_clock::now();
+    rope.get_str();
+    report("rope flatten (get_str)", ms_since(start), rope.get_length());
+    rope = Mystring_Rope{};
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < flat_pieces; i++)
+        flat = piece + flat;
+    report("flat prepend (" + to_string(flat_limit / (1024 * 1024)) + " MiB only)", ms_since(start), flat.get_length());
+    flat = Mystring{};
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < pieces; i++)
+        rope.prepend(piece);
+    report("rope prepend", ms_since(start), rope.get_length());
+    rope = Mystring_Rope{};
+
+    mt19937_64 rng {7};
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < flat_pieces; i++) {
+        size_t pos = flat.get_length() ? rng() % flat.get_length() : 0;
+        flat = Mystring{flat.substr(0, pos)} + piece + flat.substr(pos);
+    }
+    report("flat middle insert (" + to_string(flat_limit / (1024 * 1024)) + " MiB only)", ms_since(start), flat.get_length());
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < pieces / 10; i++)
+        rope.insert(rope.get_length() ? rng() % rope.get_length() : 0, piece);
+    report("rope middle insert", ms_since(start), rope.get_length());
+}
+
+// Word count over the whole text, repeated `passes` times: ordered map vs hash map
+void bench_word_count(const string &text, int passes) {
+    istringstream in {text};
+    vector<Mystring> words = Mystring::read_words(in);
+
+    auto start = chrono::steady_clock::now();
+    map<Mystring, int> ordered;
+    for (int pass = 0; pass < passes; pass++)
+        for (const Mystring &word : words)
+            ordered[word]++;
+    auto t1 = chrono::steady_clock::now();
+    unordered_map<Mystring, int> hashed;
+    hashed.reserve(ordered.size());
+    for (int pass = 0; pass < passes; pass++)
+        for (const Mystring &word : words)
+            hashed[word]++;
+    auto t2 = chrono::steady_clock::now();
+
+    cout << setw(28) << left << "std::map<Mystring, int>" << right << fixed << setprecision(1)
+         << setw(8) << chrono::duration<double, milli>(t1 - start).count() << " ms   ("
+         << ordered.size() << " distinct, \"the\" x " << ordered["the"] << ")" << endl;
+    cout << setw(28) << left << "std::unordered_map" << right
+         << setw(8) << chrono::duration<double, milli>(t2 - t1).count() << " ms   ("
+         << hashed.size() << " distinct, \"the\" x " << hashed["the"] << ")" << endl;
+
+    Mystring big = Mystring{"0123456789abcdef"} * (64 * 1024 * 1024 / 16);
+    auto t3 = chrono::steady_clock::now();
+    size_t h = big.hash();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t3).count();
+    cout << setw(28) << left << "hash() of 64 MiB" << right
+         << setw(8) << seconds * 1000.0 << " ms   (" << 64.0 / 1024.0 / seconds << " GiB/s, " << hex << h << dec << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    cout << "=== Allocations per " << iterations << " constructions ===" << endl;
+    bench_constructions("empty string", "");
+    bench_constructions("short word \"frank\"", "frank");
+    bench_constructions("15 chars (largest inline)", "abcdefghijklmno");
+    bench_constructions("16 chars (first on heap)", "abcdefghijklmnop");
+    bench_constructions("long sentence", "Two households, both alike in dignity, in fair Verona");
+
+    cout << "\n=== Appending one character at a time ===" << endl;
+    bench_appends(iterations);
+    bench_appends(10 * iterations);
+
+    cout << "\n=== Repetition with operator* ===" << endl;
+    for (int n : {1'000, 10'000, 100'000, 1'000'000, 10'000'000})
+        bench_repeat(n);
+
+    cout << "\n=== Case conversion and comparison ===" << endl;
+    bench_lowercase(100'000'000);
+    bench_sort_dedupe(iterations);
+
+    cout << "\n=== Comparing against a literal, " << iterations << " times ===" << endl;
+    bench_literal_compare();
+
+    const char *text_file = argc > 1 ? argv[1] : "../../Section19Challenge/Challenge3/romeoandjuliet.txt";
+    ifstream in_file {text_file};
+    if (in_file) {
+        ostringstream contents;
+        contents << in_file.rdbuf();
+        cout << "\n=== Word extraction, " << text_file << " x 50 ===" << endl;
+        bench_extraction(contents.str(), 50);
+
+        cout << "\n=== Interning the words of " << text_file << " ===" << endl;
+        bench_interning(contents.str(), 1);
+        bench_interning(contents.str(), 4);
+
+        cout << "\n=== Word count of " << text_file << " x 20 ===" << endl;
+        bench_word_count(contents.str(), 20);
+    } else {
+        cerr << "\nCould not open " << text_file << " - skipping extraction benchmark" << endl;
+    }
+
+    cout << "\n=== Build-then-discard, 10 batches of " << iterations << " strings ===" << endl;
+    bench_batch(iterations, 10);
+
+    cout << "\n=== Building a 100 MiB document from 100-char pieces ===" << endl;
+    bench_rope(100 * 1024 * 1024, 1024 * 1024);
+    return 0;
+}
@@ -1,184 +1,476 @@
 #include <iostream>
 #include <cstring>
+#include <limits>
+#include <locale>
+#include <stdexcept>
 #include "Mystring.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ASCII case conversion kernels
+// Flips the 0x20 case bit of every byte in [first, last] ('A'-'Z' to lowercase, 'a'-'z' to uppercase).
+// Bytes are shifted so the range starts at -128; then one signed compare tells us which bytes are in range.
+// This matches tolower/toupper in the default "C" locale, which the original code relied on.
+static void ascii_flip_case(char *s, size_t len, char first, char last) {
+    size_t idx = 0;
+#if defined(__AVX2__)
+    const __m256i shift = _mm256_set1_epi8(static_cast<char>(-128 - first));
+    const __m256i bound = _mm256_set1_epi8(static_cast<char>(-128 + (last - first) + 1));
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    for (; idx + 32 <= len; idx += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + idx));
+        __m256i in_range = _mm256_cmpgt_epi8(bound, _mm256_add_epi8(chunk, shift));
+        chunk = _mm256_xor_si256(chunk, _mm256_and_si256(in_range, flip));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(s + idx), chunk);
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    const __m128i shift16 = _mm_set1_epi8(static_cast<char>(-128 - first));
+    const __m128i bound16 = _mm_set1_epi8(static_cast<char>(-128 + (last - first) + 1));
+    const __m128i flip16 = _mm_set1_epi8(0x20);
+    for (; idx + 16 <= len; idx += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + idx));
+        __m128i in_range = _mm_cmplt_epi8(_mm_add_epi8(chunk, shift16), bound16);
+        chunk = _mm_xor_si128(chunk, _mm_and_si128(in_range, flip16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(s + idx), chunk);
+    }
+#endif
+    // Scalar fallback for the tail (and for targets without SSE2)
+    for (; idx < len; idx++) {
+        if (s[idx] >= first && s[idx] <= last)
+            s[idx] ^= 0x20;
+    }
+}
+
+// Storage helpers
+// Strings up to sso_capacity characters live in small_buff; only longer ones go to the heap (or the arena)
+// length and capacity are kept up to date so nothing has to rescan the buffer with strlen
+bool Mystring::is_small() const {
+    return str == small_buff;
+}
+
+char *Mystring::new_buffer(size_t len) {
+    if (arena)
+        return arena->allocate(len + 1);
+    return new char[len + 1];
+}
+
+void Mystring::delete_buffer() {
+    if (!is_small() && !arena)
+        delete [] str;
+}
+
+// Only called on an empty object (freshly constructed or release()d)
+void Mystring::allocate(size_t len) {
+    if (len <= sso_capacity) {
+        str = small_buff;
+        capacity = sso_capacity;
+    } else {
+        str = new_buffer(len);
+        capacity = len;
+    }
+    str[len] = '\0';
+    length = len;
+}
+
+void Mystring::init(const char *s, size_t len) {
+    allocate(len);
+    std::memcpy(str, s, len);
+}
+
+void Mystring::release() {
+    delete_buffer();
+    str = small_buff;
+    *str = '\0';
+    length = 0;
+    capacity = sso_capacity;
+}
+
+void Mystring::steal(Mystring &source) {
+    str = source.str;
+    length = source.length;
+    capacity = source.capacity;
+    source.str = source.small_buff;
+    *source.str = '\0';
+    source.length = 0;
+    source.capacity = sso_capacity;
+}
+
+void Mystring::reserve(size_t new_capacity) {
+    if (new_capacity <= capacity)
+        return;
+    char *buff = new_buffer(new_capacity);
+    std::memcpy(buff, str, length + 1);
+    delete_buffer();
+    str = buff;
+    capacity = new_capacity;
+}
+
+// Doubling the capacity whenever we run out keeps a run of appends at amortized O(1) per character
+// s may point into our own buffer (s += s, s += s.substr(...)), so its position is rebased if the buffer moves
+void Mystring::append(const char *s, size_t len) {
+    if (length + len > capacity) {
+        bool aliased = s >= str && s <= str + length;
+        size_t offset = s - str;
+        size_t new_capacity = capacity * 2;
+        if (new_capacity < length + len)
+            new_capacity = length + len;
+        reserve(new_capacity);
+        if (aliased)
+            s = str + offset;
+    }
+    std::memmove(str + length, s, len);
+    length += len;
+    str[length] = '\0';
+}
+
+// Each memcpy doubles the filled prefix, so "abc" * n takes O(log n) bulk copies instead of n small ones
+void Mystring::fill_repeats(size_t unit_len, size_t total_len) {
+    size_t filled = unit_len;
+    while (filled * 2 <= total_len) {
+        std::memcpy(str + filled, str, filled);
+        filled *= 2;
+    }
+    std::memcpy(str + filled, str, total_len - filled);
+    length = total_len;
+    str[length] = '\0';
+}
+
  // No-args constructor
 Mystring::Mystring() 
-    : str{nullptr} {
-    str = new char[1];
+    : str{small_buff}, length{0}, capacity{sso_capacity}, arena{nullptr} {
     *str = '\0';
 }
 
 // Overloaded constructor
 Mystring::Mystring(const char *s) 
-    : str {nullptr} {
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{nullptr} {
+        if (s==nullptr) {
+            *str = '\0';
+        } else {
+            init(s, strlen(s));
+        }
+}
+
+// Overloaded constructor - copies exactly len chars, so s does not need to be '\0' terminated
+Mystring::Mystring(const char *s, size_t len)
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{nullptr} {
+        init(s, len);
+}
+
+// Arena constructors
+Mystring::Mystring(Mystring_Arena &arena)
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{&arena} {
+    *str = '\0';
+}
+
+Mystring::Mystring(const char *s, Mystring_Arena &arena)
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{&arena} {
         if (s==nullptr) {
-            str = new char[1];
             *str = '\0';
         } else {
-            str = new char[strlen(s)+1];
-            strcpy(str, s);
+            init(s, strlen(s));
         }
 }
 
+Mystring::Mystring(const char *s, size_t len, Mystring_Arena &arena)
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{&arena} {
+        init(s, len);
+}
+
+// Copies the characters a view refers to
+Mystring::Mystring(Mystring_View view)
+    : str {small_buff}, length{0}, capacity{sso_capacity}, arena{nullptr} {
+        init(view.get_str(), view.get_length());
+}
+
 // Copy constructor
+// The copy always goes to the heap, so copying out of a batch is safe after the arena is reset
 Mystring::Mystring(const Mystring &source) 
-    : str{nullptr} {
-        str = new char[strlen(source.str)+ 1];
-        strcpy(str, source.str);
+    : str{small_buff}, length{0}, capacity{sso_capacity}, arena{nullptr} {
+        init(source.str, source.length);
  //       std::cout << "Copy constructor used" << std::endl;
 
 }
 
 // Move constructor
+// A small source has nothing to steal, so its characters are copied instead
+// The new object uses the same arena as source, since it may take over source's buffer
 Mystring::Mystring( Mystring &&source) 
-    :str(source.str) {
-        source.str = nullptr;
+    :str(small_buff), length{0}, capacity{sso_capacity}, arena{source.arena} {
+        if (source.is_small())
+            init(source.str, source.length);
+        else
+            steal(source);
 //        std::cout << "Move constructor used" << std::endl;
 }
 
  // Destructor
 Mystring::~Mystring() {
-    delete [] str;
+    delete_buffer();
 }
 
  // Copy assignment
+// Reuses the existing buffer when it is already big enough; the lhs keeps its own arena (or the heap)
 Mystring &Mystring::operator=(const Mystring &rhs) {
 //    std::cout << "Using copy assignment" << std::endl;
 
     if (this == &rhs) 
         return *this;
-    delete [] str;
-    str = new char[strlen(rhs.str) + 1];
-    strcpy(str, rhs.str);
+    if (rhs.length <= capacity) {
+        std::memcpy(str, rhs.str, rhs.length + 1);
+        length = rhs.length;
+    } else {
+        release();
+        init(rhs.str, rhs.length);
+    }
     return *this;
 }
 
 // Move assignment
+// A buffer can only be taken over if it came from the same place (heap or arena) that we allocate from
 Mystring &Mystring::operator=( Mystring &&rhs) {
  //   std::cout << "Using move assignment" << std::endl;
     if (this == &rhs) 
         return *this;
-    delete [] str;
-    str = rhs.str;
-    rhs.str = nullptr;
+    release();
+    if (rhs.is_small() || rhs.arena != arena)
+        init(rhs.str, rhs.length);
+    else
+        steal(rhs);
     return *this;
 }
 
+// Conversion to a view - just the pointer and the cached length
+Mystring::operator Mystring_View() const {
+    return Mystring_View{str, length};
+}
+
 // String Manipulation and Concatenation
 // unary minus - returns lowercase version of object's string
-Mystring Mystring::operator-(){
-    char *buff = new char[std::strlen(str) + 1];
-    std::strcpy(buff, str);
-    for (size_t idx = 0; idx < std::strlen(buff); idx++){
-        buff[idx] = tolower(buff[idx]);
-    }
-
-    Mystring temp {buff};
-    delete [] buff;
+// Copies straight into the result and lowercases that, instead of going through a scratch buffer
+Mystring Mystring::operator-() const{
+    Mystring temp {*this};
+    temp.to_lower();
     return temp;
-
 }
 
 //concatenation - returns an object that concatenates the lhs and rhs
-Mystring Mystring::operator+(const Mystring &rhs) const{
-    Mystring temp {std::strcat(str, rhs.str)};
+// The result is sized once up front and filled with two bulk copies
+Mystring Mystring::operator+(Mystring_View rhs) const{
+    Mystring temp;
+    temp.allocate(length + rhs.get_length());
+    std::memcpy(temp.str, str, length);
+    std::memcpy(temp.str + length, rhs.get_str(), rhs.get_length());
     return temp;
 } 
 
 //concatenate the rhs string to the lhs string and store the result in lhs object. a += b is equivalent to a = a+b
-Mystring &Mystring::operator+=(const Mystring &rhs){
-    *this = *this + rhs;
+// Appends in place instead of rebuilding through operator+, so repeated += is amortized O(1) per character
+Mystring &Mystring::operator+=(Mystring_View rhs){
+    append(rhs.get_str(), rhs.get_length());
     return *this;
 }   
 
 //create a string consisting of the initial string repeated n many times (e.g. "abc" * 3 = "abcabcabc")
+// The final size is known before anything is copied, so the result needs at most one allocation
 Mystring Mystring::operator*(int n) const{
+    Mystring temp;
+    if (n <= 0 || length == 0)
+        return temp;
+    if (static_cast<size_t>(n) > std::numeric_limits<size_t>::max() / length - 1)
+        throw std::length_error("Mystring::operator*: result is too long");
+
+    temp.allocate(length * n);
+    std::memcpy(temp.str, str, length);
+    temp.fill_repeats(length, length * n);
+    return temp;
+}
 
-    //implementation using + operator defined above
-    Mystring temp {str};
-    for (size_t idx = 0; idx < (n-1); idx++){
-        temp += str;
+//do the same as the * operator but assign it to the lhs object
+// Repeats in place: grows the buffer once (if needed) and doubles the string inside it
+Mystring &Mystring::operator*=(int n){
+    if (n <= 0 || length == 0) {
+        release();
+        return *this;
     }
+    if (static_cast<size_t>(n) > std::numeric_limits<size_t>::max() / length - 1)
+        throw std::length_error("Mystring::operator*=: result is too long");
 
-    // // Ground-up implementation
-    // int input_len = std::strlen(str);
-    // char *buff = new char [(input_len*n)+1];
-    // for (size_t i = 0; i < n; i++){
-    //     for (size_t j = 0; j < input_len; j++){
-    //         buff[j + (i*input_len)] = str[j];
-    //     }
-    // }
-    // Mystring temp {buff};
-    // delete [] buff;
-
-    /*
-    // His ground-up implementation
-    size_t buff_size = std::strlen(str) * n + 1;
-    char *buff = new char[buff_size];
-    strcpy(buff, "");
-    for (int i =1; i <=n; i++)
-        strcat(buff, str);
-    Mystring temp{buff};
-    delete [] buff;
-    return temp;
-    */
-
+    reserve(length * n);
+    fill_repeats(length, length * n);
+    return *this;
+}
 
-    return temp;
+// Case conversion in place
+Mystring &Mystring::to_lower(){
+    ascii_flip_case(str, length, 'A', 'Z');
+    return *this;
 }
 
-//do the same as the * operator but assign it to the lhs object
-Mystring &Mystring::operator*=(int n){
-    *this = (*this) * n;
+Mystring &Mystring::to_upper(){
+    ascii_flip_case(str, length, 'a', 'z');
     return *this;
 }
 
 
+// Substrings and search
+Mystring_View Mystring::substr(size_t pos, size_t count) const{
+    return Mystring_View{*this}.substr(pos, count);
+}
+
+size_t Mystring::find(Mystring_View needle, size_t pos) const{
+    return Mystring_View{*this}.find(needle, pos);
+}
+
+
 // Comparison Operator Overloading
 
 //returns true if two strings are equal
-bool Mystring::operator==(const Mystring &rhs) const{
-    return (std::strcmp(str, rhs.str) == 0);
+// Strings of different lengths can never be equal, so that is checked before looking at any characters
+bool Mystring::operator==(Mystring_View rhs) const{
+    return length == rhs.get_length() && std::memcmp(str, rhs.get_str(), length) == 0;
 }
 
 //returns false if two strings are not equal
-bool Mystring::operator!=(const Mystring &rhs) const{
-    return (std::strcmp(str, rhs.str) != 0);
+bool Mystring::operator!=(Mystring_View rhs) const{
+    return !(*this == rhs);
 }
 
 //returns true if the lhs string is lexically less than the rhs string
-bool Mystring::operator<(const Mystring &rhs) const{
-    return (std::strcmp(str, rhs.str) < 0);
+bool Mystring::operator<(Mystring_View rhs) const{
+    return compare(rhs) < 0;
 } 
 
 // returns false if the lhs string is lexically less than the rhs string
-bool Mystring::operator>(const Mystring &rhs) const{
-    return (std::strcmp(str, rhs.str) > 0);
+bool Mystring::operator>(Mystring_View rhs) const{
+    return compare(rhs) > 0;
+}
+
+// Same ordering as strcmp - see Mystring_View::compare
+int Mystring::compare(Mystring_View rhs) const{
+    return Mystring_View{*this}.compare(rhs);
+}
+
+// Hashes the cached length and the characters - see Mystring_View::hash
+size_t Mystring::hash() const{
+    return Mystring_View{*this}.hash();
 }
 
 
 // Display method
 void Mystring::display() const {
-    std::cout << str << " : " << get_length() << std::endl;
+    std::cout << *this << " : " << get_length() << std::endl;
 }
 
  // getters
- int Mystring::get_length() const { return strlen(str); }
+ int Mystring::get_length() const { return static_cast<int>(length); }
+ size_t Mystring::get_capacity() const { return capacity; }
+ Mystring_Arena *Mystring::get_arena() const { return arena; }
  const char *Mystring::get_str() const { return str; }
 
 // overloaded insertion operator
+// Writes all length bytes, so embedded NULs come out too (as Mystring_View's inserter does)
 std::ostream &operator<<(std::ostream &os, const Mystring &rhs) {
-    os << rhs.str;
+    os.write(rhs.str, static_cast<std::streamsize>(rhs.length));
     return os;
 }
 
 // overloaded extraction operator
+// Reads straight from the stream buffer into rhs's own storage, a chunk at a time.
+// Like std::string extraction: skips leading whitespace, honours in.width(), and
+// only grows rhs when the word does not fit in the space it already has.
 std::istream &operator>>(std::istream &in, Mystring &rhs) {
-    char *buff = new char[1000];
-    in >> buff;
-    rhs = Mystring{buff};
-    delete [] buff;
+    std::istream::sentry sentry {in};       // skips leading whitespace
+    if (!sentry)
+        return in;
+
+    const std::ctype<char> &ct = std::use_facet<std::ctype<char>>(in.getloc());
+    std::streambuf *sb = in.rdbuf();
+    size_t max_len = in.width() > 0 ? static_cast<size_t>(in.width()) : std::numeric_limits<size_t>::max();
+    constexpr size_t chunk_size {128};
+    char chunk[chunk_size];
+    size_t chunk_len {0};
+
+    rhs.length = 0;
+    rhs.str[0] = '\0';
+    int c = sb->sgetc();
+    while (rhs.length + chunk_len < max_len) {
+        if (c == std::char_traits<char>::eof()) {
+            in.setstate(std::ios_base::eofbit);
+            break;
+        }
+        char ch = std::char_traits<char>::to_char_type(c);
+        if (ct.is(std::ctype_base::space, ch))
+            break;
+        chunk[chunk_len++] = ch;
+        if (chunk_len == chunk_size) {
+            rhs.append(chunk, chunk_len);
+            chunk_len = 0;
+        }
+        c = sb->snextc();
+    }
+    rhs.append(chunk, chunk_len);
+    in.width(0);
+    if (rhs.length == 0)
+        in.setstate(std::ios_base::failbit);
     return in;
 }
 
+// Bulk tokenizer
+// Pulls the whole stream into one buffer, counts the words so the vector is reserved exactly once,
+// then builds each word straight from the buffer (short words land in their small_buff, no allocation).
+// Stream state follows operator>>: nothing is read from a stream that isn't good, the whole stream is
+// consumed (eofbit), and failbit is set when there was no word in it.
+std::vector<Mystring> Mystring::read_words(std::istream &in, Mystring_Arena *arena) {
+    std::istream::sentry sentry {in, true};     // noskipws: the scan below skips whitespace itself
+    std::streambuf *sb = in.rdbuf();
+    if (!sentry || sb == nullptr)
+        return {};
+
+    Mystring text;
+    std::streamsize got {0};
+    do {
+        text.reserve(text.capacity < 4096 ? 4096 : text.capacity * 2);
+        got = sb->sgetn(text.str + text.length, text.capacity - text.length);
+        text.length += got;
+    } while (text.length == text.capacity);
+    text.str[text.length] = '\0';
+    in.setstate(std::ios_base::eofbit);
+
+    const std::ctype<char> &ct = std::use_facet<std::ctype<char>>(in.getloc());
+    bool is_space[256];
+    for (int c = 0; c < 256; c++)
+        is_space[c] = ct.is(std::ctype_base::space, static_cast<char>(c));
+
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(text.str);
+    size_t word_count {0};
+    bool in_word {false};
+    for (size_t idx = 0; idx < text.length; idx++) {
+        bool space = is_space[p[idx]];
+        word_count += (!space && !in_word);
+        in_word = !space;
+    }
+
+    std::vector<Mystring> words;
+    words.reserve(word_count);
+    size_t idx {0};
+    while (idx < text.length) {
+        while (idx < text.length && is_space[p[idx]])
+            idx++;
+        size_t start = idx;
+        while (idx < text.length && !is_space[p[idx]])
+            idx++;
+        if (idx > start && arena)
+            words.emplace_back(text.str + start, idx - start, *arena);
+        else if (idx > start)
+            words.emplace_back(text.str + start, idx - start);
+    }
+    if (words.empty())
+        in.setstate(std::ios_base::failbit);
+    return words;
+}
@@ -1,5 +1,10 @@
 #ifndef _MYSTRING_H_
 #define _MYSTRING_H_
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+#include "Mystring_Arena.h"
+#include "Mystring_View.h"
 
 class Mystring
 {
@@ -7,10 +12,31 @@ class Mystring
     friend std::istream &operator>>(std::istream &in, Mystring &rhs);
 
 private:
-    char *str;      // pointer to a char[] that holds a C-style string
+    static constexpr size_t sso_capacity = 15;  // longest string that is stored inside the object itself
+
+    char *str;                           // points to small_buff or to a heap char[] that holds a C-style string
+    size_t length;                       // number of characters in str, not counting the '\0'
+    size_t capacity;                     // number of characters str can hold, not counting the '\0'
+    Mystring_Arena *arena;               // where long strings get their buffer from - nullptr means new[]/delete[]
+    char small_buff[sso_capacity + 1];   // inline storage for short strings, avoids new[] entirely
+
+    bool is_small() const;                     // true when str points to small_buff
+    char *new_buffer(size_t len);              // room for len chars plus '\0', from the arena or the heap
+    void delete_buffer();                      // gives back a heap buffer (arena buffers are freed by Mystring_Arena::reset)
+    void allocate(size_t len);                 // points str at storage for exactly len chars (the characters are left for the caller to fill)
+    void init(const char *s, size_t len);      // points str at the right storage and copies len chars of s into it
+    void release();                            // frees heap storage (if any) and leaves the object empty
+    void steal(Mystring &source);              // takes over source's heap buffer and leaves source empty (both must share an arena)
+    void append(const char *s, size_t len);    // appends len chars of s, growing the buffer geometrically
+    void fill_repeats(size_t unit_len, size_t total_len);   // repeats the first unit_len chars of str until it is total_len long
 public:
     Mystring();                                                         // No-args constructor
     Mystring(const char *s);                                     // Overloaded constructor
+    Mystring(const char *s, size_t len);                     // Overloaded constructor - first len chars of s
+    explicit Mystring(Mystring_Arena &arena);             // Arena constructors - long strings are stored in arena
+    Mystring(const char *s, Mystring_Arena &arena);
+    Mystring(const char *s, size_t len, Mystring_Arena &arena);
+    explicit Mystring(Mystring_View view);              // Copies the characters a view refers to
     Mystring(const Mystring &source);                    // Copy constructor
     Mystring( Mystring &&source);                         // Move constructor
     ~Mystring();                                                     // Destructor
@@ -18,27 +44,70 @@ public:
     Mystring &operator=(const Mystring &rhs);     // Copy assignment
     Mystring &operator=(Mystring &&rhs);           // Move assignment
 
+    operator Mystring_View() const;                // a Mystring can be passed anywhere a view is expected
+
     // String Manipulation and Concatenation
-    Mystring operator-(); // unary minus - returns lowercase version of object's string
-    Mystring operator+(const Mystring &rhs) const; //concatenation - returns an object that concatenates the lhs and rhs
-    Mystring &operator+=(const Mystring &rhs);     //concatenate the rhs string to the lhs string and store the result in lhs object. a += b is equivalent to a = a+b
+    Mystring operator-() const; // unary minus - returns lowercase version of object's string
+    Mystring operator+(Mystring_View rhs) const; //concatenation - returns an object that concatenates the lhs and rhs
+    Mystring &operator+=(Mystring_View rhs);     //concatenate the rhs string to the lhs string and store the result in lhs object. a += b is equivalent to a = a+b
     Mystring operator*(int n) const; //create a string consisting of the initial string repeated n many times (e.g. "abc" * 3 = "abcabcabc")
     Mystring &operator*=(int n); //do the same as the * operator but assign it to the lhs object
 
+    void reserve(size_t new_capacity);         // grows the buffer to hold at least new_capacity characters
+
+    // In-place case conversion (ASCII letters only) - no copy, no allocation
+    Mystring &to_lower();
+    Mystring &to_upper();
+
+
+    // Substrings and search - views into this string, nothing is copied
+    Mystring_View substr(size_t pos, size_t count = Mystring_View::npos) const;
+    size_t find(Mystring_View needle, size_t pos = 0) const;   // index of the first match, or Mystring_View::npos
 
     // Comparison Operator Overloading
-    bool operator==(const Mystring &rhs) const; //returns true if two strings are equal
-    bool operator!=(const Mystring &rhs) const; //returns false if two strings are not equal
-    bool operator<(const Mystring &rhs) const; //returns true if the lhs string is lexically less than the rhs string
-    bool operator>(const Mystring &rhs) const; // returns false if the lhs string is lexically less than the rhs string
+    // rhs is a view, so comparing against a literal (s == "abc") does not build a temporary Mystring;
+    // "abc" == s is handled by the Mystring_View operators
+    bool operator==(Mystring_View rhs) const; //returns true if two strings are equal
+    bool operator!=(Mystring_View rhs) const; //returns false if two strings are not equal
+    bool operator<(Mystring_View rhs) const; //returns true if the lhs string is lexically less than the rhs string
+    bool operator>(Mystring_View rhs) const; // returns false if the lhs string is lexically less than the rhs string
+    int compare(Mystring_View rhs) const;    // <0, 0 or >0 with the same meaning as std::strcmp
+    size_t hash() const;                     // same value as the hash of a view of the same characters
 
 
     
     
     void display() const;
+
+    // Reads every whitespace-separated word from in; the whole vector is reserved once up front
+    // If an arena is given, the long words are stored in it
+    static std::vector<Mystring> read_words(std::istream &in, Mystring_Arena *arena = nullptr);
     
     int get_length() const;                                      // getters
+    size_t get_capacity() const;
+    Mystring_Arena *get_arena() const;
     const char *get_str() const;
 };
 
+// Hashing for unordered containers
+// std::hash<Mystring> lets Mystring be used as a key as-is. Mystring_Hash and Mystring_Equal also
+// accept const char * and views and are marked transparent, so in C++20 mode
+// std::unordered_map<Mystring, T, Mystring_Hash, Mystring_Equal>::find("abc") does not build a Mystring.
+namespace std {
+    template <>
+    struct hash<Mystring> {
+        size_t operator()(const Mystring &s) const noexcept { return s.hash(); }
+    };
+}
+
+struct Mystring_Hash {
+    using is_transparent = void;
+    size_t operator()(Mystring_View view) const noexcept { return view.hash(); }
+};
+
+struct Mystring_Equal {
+    using is_transparent = void;
+    bool operator()(Mystring_View lhs, Mystring_View rhs) const noexcept { return lhs == rhs; }
+};
+
 #endif // _MYSTRING_H_
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "Mystring_Arena.h"
+
+Mystring_Arena::Mystring_Arena(size_t block_size)
+    : block_size{block_size}, current_block{0}, offset{0}, bytes_allocated{0} {
+}
+
+Mystring_Arena::~Mystring_Arena() {
+    for (char *block : blocks)
+        delete [] block;
+    for (char *block : large_blocks)
+        delete [] block;
+}
+
+// Bump allocation: move to the next block (creating it if needed) when the current one is full
+char *Mystring_Arena::allocate(size_t bytes) {
+    bytes_allocated += bytes;
+    if (bytes > block_size) {
+        large_blocks.push_back(new char[bytes]);
+        return large_blocks.back();
+    }
+    if (blocks.empty() || offset + bytes > block_size) {
+        if (!blocks.empty())
+            current_block++;
+        if (current_block == blocks.size())
+            blocks.push_back(new char[block_size]);
+        offset = 0;
+    }
+    char *p = blocks[current_block] + offset;
+    offset += bytes;
+    return p;
+}
+
+// Releases every string in the batch in one step
+void Mystring_Arena::reset() {
+    for (char *block : large_blocks)
+        delete [] block;
+    large_blocks.clear();
+    current_block = 0;
+    offset = 0;
+    bytes_allocated = 0;
+}
+
+size_t Mystring_Arena::get_bytes_allocated() const { return bytes_allocated; }
+size_t Mystring_Arena::get_block_count() const { return blocks.size() + large_blocks.size(); }
@@ -0,0 +1,35 @@
+#ifndef _MYSTRING_ARENA_H_
+#define _MYSTRING_ARENA_H_
+#include <cstddef>
+#include <vector>
+
+// Monotonic arena for Mystring buffers
+// Hands out memory by bumping an offset inside large blocks. Individual strings never free
+// anything; the whole batch is released at once with reset(), which keeps the blocks for reuse.
+// Every Mystring that uses the arena must be destroyed (or reassigned) before reset() is called.
+class Mystring_Arena
+{
+private:
+    static constexpr size_t def_block_size = 64 * 1024;
+
+    size_t block_size;                 // size of each regular block
+    std::vector<char *> blocks;        // regular blocks, reused after reset()
+    std::vector<char *> large_blocks;  // dedicated blocks for requests bigger than block_size, freed by reset()
+    size_t current_block;              // index into blocks of the block we are carving from
+    size_t offset;                     // bytes already handed out from blocks[current_block]
+    size_t bytes_allocated;            // bytes handed out since the last reset()
+public:
+    explicit Mystring_Arena(size_t block_size = def_block_size);
+    ~Mystring_Arena();
+
+    Mystring_Arena(const Mystring_Arena &) = delete;
+    Mystring_Arena &operator=(const Mystring_Arena &) = delete;
+
+    char *allocate(size_t bytes);
+    void reset();
+
+    size_t get_bytes_allocated() const;        // getters
+    size_t get_block_count() const;
+};
+
+#endif // _MYSTRING_ARENA_H_
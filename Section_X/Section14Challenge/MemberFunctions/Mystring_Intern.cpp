@@ -0,0 +1,100 @@
+#include <iostream>
+#include <mutex>
+#include "Mystring_Intern.h"
+
+// Interned_Mystring
+
+Interned_Mystring::Interned_Mystring(const Mystring *canonical)
+    : canonical{canonical} {
+}
+
+// The empty string, shared by every default-constructed handle
+Interned_Mystring::Interned_Mystring()
+    : canonical{nullptr} {
+    static const Mystring empty;
+    canonical = &empty;
+}
+
+bool Interned_Mystring::operator==(const Interned_Mystring &rhs) const {
+    return canonical == rhs.canonical;
+}
+
+bool Interned_Mystring::operator!=(const Interned_Mystring &rhs) const {
+    return canonical != rhs.canonical;
+}
+
+Interned_Mystring::operator Mystring_View() const {
+    return *canonical;
+}
+
+// getters
+const Mystring &Interned_Mystring::get() const { return *canonical; }
+const char *Interned_Mystring::get_str() const { return canonical->get_str(); }
+int Interned_Mystring::get_length() const { return canonical->get_length(); }
+
+// overloaded insertion operator
+std::ostream &operator<<(std::ostream &os, const Interned_Mystring &rhs) {
+    os << *rhs.canonical;
+    return os;
+}
+
+
+// Mystring_Intern_Table
+
+Mystring_Intern_Table::Mystring_Intern_Table()
+    : lookups{0}, hits{0}, bytes_saved{0} {
+}
+
+// Fast path: shared lock and a lookup. Only a miss takes the shard's exclusive lock, and it looks
+// again first, because another thread may have added the same string in between.
+Interned_Mystring Mystring_Intern_Table::intern(Mystring_View text) {
+    size_t hash = text.hash();              // the only time the characters are hashed
+    Hashed_View key {text, hash};
+    Shard &shard = shards[(hash >> 32) % shard_count];
+    lookups.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::shared_lock<std::shared_mutex> lock {shard.mutex};
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            bytes_saved.fetch_add(text.get_length() + 1, std::memory_order_relaxed);
+            return Interned_Mystring{it->second};
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock {shard.mutex};
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        bytes_saved.fetch_add(text.get_length() + 1, std::memory_order_relaxed);
+        return Interned_Mystring{it->second};
+    }
+    shard.strings.emplace_back(text);
+    const Mystring *canonical = &shard.strings.back();
+    shard.index.emplace(Hashed_View{*canonical, hash}, canonical);
+    return Interned_Mystring{canonical};
+}
+
+Mystring_Intern_Table &Mystring_Intern_Table::global() {
+    static Mystring_Intern_Table table;
+    return table;
+}
+
+// getters - statistics
+size_t Mystring_Intern_Table::get_size() const {
+    size_t size {0};
+    for (const Shard &shard : shards) {
+        std::shared_lock<std::shared_mutex> lock {shard.mutex};
+        size += shard.strings.size();
+    }
+    return size;
+}
+
+size_t Mystring_Intern_Table::get_lookups() const { return lookups.load(std::memory_order_relaxed); }
+size_t Mystring_Intern_Table::get_hits() const { return hits.load(std::memory_order_relaxed); }
+size_t Mystring_Intern_Table::get_bytes_saved() const { return bytes_saved.load(std::memory_order_relaxed); }
+
+double Mystring_Intern_Table::get_hit_rate() const {
+    size_t total = get_lookups();
+    return total ? static_cast<double>(get_hits()) / total : 0.0;
+}
@@ -0,0 +1,79 @@
+#ifndef _MYSTRING_INTERN_H_
+#define _MYSTRING_INTERN_H_
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+#include "Mystring.h"
+
+// Handle to the one canonical copy of a string in a Mystring_Intern_Table
+// Copying a handle copies a pointer; two handles from the same table are equal exactly when
+// they point at the same entry, so equality is a single pointer compare.
+class Interned_Mystring
+{
+    friend class Mystring_Intern_Table;
+    friend std::ostream &operator<<(std::ostream &os, const Interned_Mystring &rhs);
+
+private:
+    const Mystring *canonical;                 // owned by the table, never moves or dies while the table lives
+    explicit Interned_Mystring(const Mystring *canonical);
+public:
+    Interned_Mystring();                       // No-args constructor - the empty string, not tied to any table
+
+    bool operator==(const Interned_Mystring &rhs) const;   // pointer compare, only valid for handles from the same table
+    bool operator!=(const Interned_Mystring &rhs) const;
+
+    operator Mystring_View() const;
+    const Mystring &get() const;               // getters
+    const char *get_str() const;
+    int get_length() const;
+};
+
+// Deduplicating string table, safe to use from many threads at once
+// Strings are spread over shards by hash. Each shard has its own reader/writer lock, so lookups of
+// strings that are already interned (the common case) only take a shared lock and run in parallel.
+class Mystring_Intern_Table
+{
+private:
+    static constexpr size_t shard_count = 64;
+
+    // Key that carries its own hash: intern() hashes the text once to pick the shard, and the
+    // index reuses that value instead of hashing the characters again
+    struct Hashed_View {
+        Mystring_View view;
+        size_t hash;
+        bool operator==(const Hashed_View &rhs) const { return hash == rhs.hash && view == rhs.view; }
+    };
+    struct Stored_Hash {
+        size_t operator()(const Hashed_View &key) const noexcept { return key.hash; }
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::deque<Mystring> strings;       // canonical copies - a deque never moves its elements
+        std::unordered_map<Hashed_View, const Mystring *, Stored_Hash> index;   // keys view into strings
+    };
+
+    Shard shards[shard_count];
+    std::atomic<size_t> lookups;
+    std::atomic<size_t> hits;
+    std::atomic<size_t> bytes_saved;        // characters (plus '\0') that callers did not have to store again
+public:
+    Mystring_Intern_Table();
+
+    Mystring_Intern_Table(const Mystring_Intern_Table &) = delete;
+    Mystring_Intern_Table &operator=(const Mystring_Intern_Table &) = delete;
+
+    Interned_Mystring intern(Mystring_View text);     // the canonical handle for text, added if it is new
+
+    static Mystring_Intern_Table &global();           // one table shared by the whole program
+
+    size_t get_size() const;                          // getters - statistics
+    size_t get_lookups() const;
+    size_t get_hits() const;
+    double get_hit_rate() const;
+    size_t get_bytes_saved() const;
+};
+
+#endif // _MYSTRING_INTERN_H_
@@ -0,0 +1,213 @@
+#include <iostream>
+#include "Mystring_Rope.h"
+
+Mystring_Rope::Node::Node(Mystring_View text, unsigned int priority)
+    : chunk{text}, size{text.get_length()}, priority{priority} {
+}
+
+ // No-args constructor
+Mystring_Rope::Mystring_Rope()
+    : root{nullptr}, rng_state{0x9E3779B97F4A7C15ULL}, flat{}, flat_valid{false} {
+}
+
+// Overloaded constructor
+Mystring_Rope::Mystring_Rope(Mystring_View text)
+    : Mystring_Rope{} {
+    append(text);
+}
+
+// Tree helpers
+
+unsigned int Mystring_Rope::next_priority() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return static_cast<unsigned int>(rng_state >> 32);
+}
+
+size_t Mystring_Rope::size_of(const std::unique_ptr<Node> &node) {
+    return node ? node->size : 0;
+}
+
+void Mystring_Rope::update(Node *node) {
+    node->size = size_of(node->left) + node->chunk.get_length() + size_of(node->right);
+}
+
+std::unique_ptr<Mystring_Rope::Node> Mystring_Rope::build(Mystring_View text) {
+    std::unique_ptr<Node> result;
+    for (size_t pos = 0; pos < text.get_length(); pos += max_chunk)
+        result = merge(std::move(result), std::make_unique<Node>(text.substr(pos, max_chunk), next_priority()));
+    return result;
+}
+
+// Joins two trees, every position in lhs coming before every position in rhs
+std::unique_ptr<Mystring_Rope::Node> Mystring_Rope::merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs) {
+    if (!lhs)
+        return rhs;
+    if (!rhs)
+        return lhs;
+    if (lhs->priority > rhs->priority) {
+        lhs->right = merge(std::move(lhs->right), std::move(rhs));
+        update(lhs.get());
+        return lhs;
+    }
+    rhs->left = merge(std::move(lhs), std::move(rhs->left));
+    update(rhs.get());
+    return rhs;
+}
+
+// Cuts node into lhs (the first pos chars) and rhs (the rest)
+// If pos falls inside a chunk, that chunk is cut in two and the tail becomes a new node in rhs
+void Mystring_Rope::split(std::unique_ptr<Node> node, size_t pos, std::unique_ptr<Node> &lhs, std::unique_ptr<Node> &rhs) {
+    if (!node) {
+        lhs = nullptr;
+        rhs = nullptr;
+        return;
+    }
+    size_t left_size = size_of(node->left);
+    size_t chunk_end = left_size + node->chunk.get_length();
+    if (pos <= left_size) {
+        std::unique_ptr<Node> left_rest;
+        split(std::move(node->left), pos, lhs, left_rest);
+        node->left = std::move(left_rest);
+        update(node.get());
+        rhs = std::move(node);
+    } else if (pos >= chunk_end) {
+        std::unique_ptr<Node> right_start;
+        split(std::move(node->right), pos - chunk_end, right_start, rhs);
+        node->right = std::move(right_start);
+        update(node.get());
+        lhs = std::move(node);
+    } else {
+        size_t cut = pos - left_size;
+        auto tail = std::make_unique<Node>(node->chunk.substr(cut), next_priority());
+        node->chunk = Mystring{node->chunk.substr(0, cut)};
+        rhs = merge(std::move(tail), std::move(node->right));
+        update(node.get());
+        lhs = std::move(node);
+    }
+}
+
+void Mystring_Rope::copy_chunks(const Node *node, Mystring &out) {
+    if (!node)
+        return;
+    copy_chunks(node->left.get(), out);
+    out += node->chunk;
+    copy_chunks(node->right.get(), out);
+}
+
+void Mystring_Rope::write_chunks(const Node *node, std::ostream &os) {
+    if (!node)
+        return;
+    write_chunks(node->left.get(), os);
+    os << Mystring_View{node->chunk};
+    write_chunks(node->right.get(), os);
+}
+
+// Editing
+
+// Small appends are added to the last chunk in place (updating the subtree sizes on the way down);
+// anything that does not fit becomes new chunks merged onto the right edge
+Mystring_Rope &Mystring_Rope::append(Mystring_View text) {
+    if (text.empty())
+        return *this;
+    flat_valid = false;
+
+    Node *last = root.get();
+    while (last && last->right)
+        last = last->right.get();
+    if (last && last->chunk.get_length() + text.get_length() <= max_chunk) {
+        for (Node *node = root.get(); node; node = node->right.get())
+            node->size += text.get_length();
+        last->chunk += text;
+        return *this;
+    }
+    root = merge(std::move(root), build(text));
+    return *this;
+}
+
+// Same idea as append, on the left edge
+Mystring_Rope &Mystring_Rope::prepend(Mystring_View text) {
+    if (text.empty())
+        return *this;
+    flat_valid = false;
+
+    Node *first = root.get();
+    while (first && first->left)
+        first = first->left.get();
+    if (first && first->chunk.get_length() + text.get_length() <= max_chunk) {
+        for (Node *node = root.get(); node; node = node->left.get())
+            node->size += text.get_length();
+        Mystring joined {text};
+        joined += first->chunk;
+        first->chunk = std::move(joined);
+        return *this;
+    }
+    root = merge(build(text), std::move(root));
+    return *this;
+}
+
+// pos past the end appends
+Mystring_Rope &Mystring_Rope::insert(size_t pos, Mystring_View text) {
+    if (pos == 0)
+        return prepend(text);
+    if (pos >= get_length())
+        return append(text);
+    if (text.empty())
+        return *this;
+    flat_valid = false;
+
+    std::unique_ptr<Node> before;
+    std::unique_ptr<Node> after;
+    split(std::move(root), pos, before, after);
+    root = merge(merge(std::move(before), build(text)), std::move(after));
+    return *this;
+}
+
+Mystring_Rope &Mystring_Rope::operator+=(Mystring_View text) {
+    return append(text);
+}
+
+// Walks down by subtree sizes - idx must be less than get_length()
+char Mystring_Rope::operator[](size_t idx) const {
+    const Node *node = root.get();
+    while (node) {
+        size_t left_size = size_of(node->left);
+        if (idx < left_size) {
+            node = node->left.get();
+        } else if (idx < left_size + node->chunk.get_length()) {
+            return node->chunk.get_str()[idx - left_size];
+        } else {
+            idx -= left_size + node->chunk.get_length();
+            node = node->right.get();
+        }
+    }
+    return '\0';
+}
+
+// One allocation of the final size, then one bulk copy per chunk
+Mystring Mystring_Rope::flatten() const {
+    Mystring result;
+    result.reserve(get_length());
+    copy_chunks(root.get(), result);
+    return result;
+}
+
+// getters
+size_t Mystring_Rope::get_length() const {
+    return size_of(root);
+}
+
+const char *Mystring_Rope::get_str() const {
+    if (!flat_valid) {
+        flat = flatten();
+        flat_valid = true;
+    }
+    return flat.get_str();
+}
+
+// overloaded insertion operator - writes chunk by chunk, no flattening needed
+std::ostream &operator<<(std::ostream &os, const Mystring_Rope &rhs) {
+    Mystring_Rope::write_chunks(rhs.root.get(), os);
+    return os;
+}
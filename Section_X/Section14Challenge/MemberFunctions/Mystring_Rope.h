@@ -0,0 +1,65 @@
+#ifndef _MYSTRING_ROPE_H_
+#define _MYSTRING_ROPE_H_
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include "Mystring.h"
+
+// Rope representation for large strings that are built up or edited piece by piece
+// The text is kept as a sequence of chunks (at most max_chunk chars each) in a treap ordered by
+// position, so append, prepend and insert touch O(log n) nodes instead of moving the whole string.
+// get_str() flattens the chunks into one contiguous C-style string when a caller needs one; the
+// flat copy is cached until the next edit.
+class Mystring_Rope
+{
+    friend std::ostream &operator<<(std::ostream &os, const Mystring_Rope &rhs);
+
+private:
+    static constexpr size_t max_chunk = 4096;
+
+    struct Node {
+        Mystring chunk;                     // this node's piece of the text
+        size_t size;                        // chars in this whole subtree
+        unsigned int priority;              // heap order - random, which keeps the tree balanced on average
+        std::unique_ptr<Node> left;         // text before chunk
+        std::unique_ptr<Node> right;        // text after chunk
+
+        Node(Mystring_View text, unsigned int priority);
+    };
+
+    std::unique_ptr<Node> root;
+    unsigned long long rng_state;           // xorshift state for node priorities
+    mutable Mystring flat;                  // cached result of get_str()
+    mutable bool flat_valid;
+
+    unsigned int next_priority();
+    std::unique_ptr<Node> build(Mystring_View text);   // a subtree holding text, cut into max_chunk pieces
+    static size_t size_of(const std::unique_ptr<Node> &node);
+    static void update(Node *node);
+    static std::unique_ptr<Node> merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs);
+    void split(std::unique_ptr<Node> node, size_t pos, std::unique_ptr<Node> &lhs, std::unique_ptr<Node> &rhs);
+    static void copy_chunks(const Node *node, Mystring &out);
+    static void write_chunks(const Node *node, std::ostream &os);
+public:
+    Mystring_Rope();                                    // No-args constructor
+    explicit Mystring_Rope(Mystring_View text);         // Overloaded constructor
+    Mystring_Rope(Mystring_Rope &&source) = default;    // Move constructor
+    Mystring_Rope &operator=(Mystring_Rope &&rhs) = default;   // Move assignment
+    Mystring_Rope(const Mystring_Rope &) = delete;      // large by design - copy explicitly with get_str()
+    Mystring_Rope &operator=(const Mystring_Rope &) = delete;
+    ~Mystring_Rope() = default;
+
+    // Editing - O(log n) each (plus the size of the inserted text)
+    Mystring_Rope &append(Mystring_View text);
+    Mystring_Rope &prepend(Mystring_View text);
+    Mystring_Rope &insert(size_t pos, Mystring_View text);
+    Mystring_Rope &operator+=(Mystring_View text);
+
+    char operator[](size_t idx) const;                  // O(log n)
+    Mystring flatten() const;                           // the whole text as one Mystring
+
+    size_t get_length() const;                          // getters
+    const char *get_str() const;                        // flattens on demand
+};
+
+#endif // _MYSTRING_ROPE_H_
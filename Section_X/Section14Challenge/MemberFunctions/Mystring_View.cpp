@@ -0,0 +1,192 @@
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include "Mystring_View.h"
+
+// Hashing
+// A port of wyhash (final version): reads the input 8 or 16 bytes at a time and mixes with
+// 64x64->128-bit multiplies, so short keys take a handful of instructions and long ones run at memory speed.
+static constexpr uint64_t wy_secret[4] {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+static void wy_mum(uint64_t &a, uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    a = lo;
+    b = hi;
+#endif
+}
+
+static uint64_t wy_mix(uint64_t a, uint64_t b) {
+    wy_mum(a, b);
+    return a ^ b;
+}
+
+static uint64_t wy_read8(const unsigned char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+static uint64_t wy_read4(const unsigned char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static uint64_t wy_read3(const unsigned char *p, size_t k) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+static uint64_t wy_hash(const char *key, size_t len, uint64_t seed) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(key);
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (wy_read4(p) << 32) | wy_read4(p + ((len >> 3) << 2));
+            b = (wy_read4(p + len - 4) << 32) | wy_read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = wy_read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i >= 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+                see1 = wy_mix(wy_read8(p + 16) ^ wy_secret[2], wy_read8(p + 24) ^ see1);
+                see2 = wy_mix(wy_read8(p + 32) ^ wy_secret[3], wy_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_mum(a, b);
+    return wy_mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+}
+
+ // No-args constructor
+Mystring_View::Mystring_View()
+    : str{""}, length{0} {
+}
+
+// View of a C-style string
+Mystring_View::Mystring_View(const char *s)
+    : str{s ? s : ""}, length{s ? std::strlen(s) : 0} {
+}
+
+// View of the first len chars of s
+Mystring_View::Mystring_View(const char *s, size_t len)
+    : str{s}, length{len} {
+}
+
+char Mystring_View::operator[](size_t idx) const {
+    return str[idx];
+}
+
+// Search
+// memchr jumps to each candidate first character, and only those get the full memcmp
+size_t Mystring_View::find(Mystring_View needle, size_t pos) const {
+    if (pos > length || needle.length > length - pos)
+        return npos;
+    if (needle.length == 0)
+        return pos;
+    const char *last = str + (length - needle.length);
+    const char *p = str + pos;
+    while (p <= last) {
+        p = static_cast<const char *>(std::memchr(p, needle.str[0], last - p + 1));
+        if (p == nullptr)
+            return npos;
+        if (std::memcmp(p, needle.str, needle.length) == 0)
+            return p - str;
+        p++;
+    }
+    return npos;
+}
+
+size_t Mystring_View::find(char c, size_t pos) const {
+    if (pos >= length)
+        return npos;
+    const char *p = static_cast<const char *>(std::memchr(str + pos, c, length - pos));
+    return p ? p - str : npos;
+}
+
+// Clamps like std::string_view::substr, except that pos past the end gives an empty view instead of throwing
+Mystring_View Mystring_View::substr(size_t pos, size_t count) const {
+    if (pos > length)
+        pos = length;
+    if (count > length - pos)
+        count = length - pos;
+    return Mystring_View{str + pos, count};
+}
+
+// Same ordering as strcmp: memcmp over the shorter length, then the shorter string comes first
+int Mystring_View::compare(Mystring_View rhs) const {
+    size_t common = length < rhs.length ? length : rhs.length;
+    int result = common ? std::memcmp(str, rhs.str, common) : 0;
+    if (result != 0)
+        return result;
+    if (length == rhs.length)
+        return 0;
+    return length < rhs.length ? -1 : 1;
+}
+
+// Uses the stored length, so the characters are read exactly once
+size_t Mystring_View::hash() const {
+    return static_cast<size_t>(wy_hash(str, length, 0));
+}
+
+// getters
+bool Mystring_View::empty() const { return length == 0; }
+size_t Mystring_View::get_length() const { return length; }
+const char *Mystring_View::get_str() const { return str; }
+
+// Comparison Operator Overloading
+// Strings of different lengths can never be equal, so that is checked before looking at any characters
+bool operator==(Mystring_View lhs, Mystring_View rhs) {
+    return lhs.get_length() == rhs.get_length()
+        && std::memcmp(lhs.get_str(), rhs.get_str(), lhs.get_length()) == 0;
+}
+
+bool operator!=(Mystring_View lhs, Mystring_View rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator<(Mystring_View lhs, Mystring_View rhs) {
+    return lhs.compare(rhs) < 0;
+}
+
+bool operator>(Mystring_View lhs, Mystring_View rhs) {
+    return lhs.compare(rhs) > 0;
+}
+
+// overloaded insertion operator
+std::ostream &operator<<(std::ostream &os, Mystring_View rhs) {
+    os.write(rhs.str, rhs.length);
+    return os;
+}
@@ -0,0 +1,54 @@
+#ifndef _MYSTRING_VIEW_H_
+#define _MYSTRING_VIEW_H_
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+
+// Non-owning, read-only window onto characters owned by someone else (a Mystring, a literal, a buffer)
+// Just a pointer and a length, so it is cheap to pass by value and never allocates.
+// The characters are not necessarily '\0' terminated - always use get_length().
+class Mystring_View
+{
+    friend std::ostream &operator<<(std::ostream &os, Mystring_View rhs);
+
+private:
+    const char *str;    // first character of the view
+    size_t length;      // number of characters in the view
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    Mystring_View();                                   // No-args constructor - empty view
+    Mystring_View(const char *s);                      // View of a C-style string
+    Mystring_View(const char *s, size_t len);          // View of the first len chars of s
+
+    char operator[](size_t idx) const;
+
+    // Search - positions are indexes into the view, npos when nothing is found
+    size_t find(Mystring_View needle, size_t pos = 0) const;
+    size_t find(char c, size_t pos = 0) const;
+    Mystring_View substr(size_t pos, size_t count = npos) const;   // narrower view, no copy
+
+    int compare(Mystring_View rhs) const;      // <0, 0 or >0 with the same meaning as std::strcmp
+    size_t hash() const;
+
+    bool empty() const;                        // getters
+    size_t get_length() const;
+    const char *get_str() const;
+};
+
+// Comparison Operator Overloading
+// Free functions, so a literal or a Mystring works on either side without building a temporary Mystring
+bool operator==(Mystring_View lhs, Mystring_View rhs);
+bool operator!=(Mystring_View lhs, Mystring_View rhs);
+bool operator<(Mystring_View lhs, Mystring_View rhs);
+bool operator>(Mystring_View lhs, Mystring_View rhs);
+
+// Lets views be used as keys in unordered containers
+namespace std {
+    template <>
+    struct hash<Mystring_View> {
+        size_t operator()(Mystring_View view) const noexcept { return view.hash(); }
+    };
+}
+
+#endif // _MYSTRING_VIEW_H_
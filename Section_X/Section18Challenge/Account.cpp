@@ -1,36 +1,51 @@
 #include "Account.h"
 
-Account::Account(std::string name, double balance) 
+Account::Account(std::string name, Money balance) 
     : name{name}, balance{balance} {
-        if (balance < 0.0)
+        if (balance < Money{})
             throw IllegalBalanceException();
 }
 
-bool Account::deposit(double amount) {
-    if (amount < 0) 
-        return false;
+Expected<Money> Account::try_deposit(Money amount) {
+    if (amount < Money{}) 
+        return Account_Error::negative_deposit;
     else {
         balance += amount;
-        return true;
+        return balance;
     }
 }
 
-void Account::withdraw(double amount) {
-    if (balance-amount >=0) {
+Expected<Money> Account::try_withdraw(Money amount) {
+    if (balance-amount >= Money{}) {
         balance-=amount;
+        return balance;
     }
     else{
-        throw InsufficientFundsException();
+        return Account_Error::insufficient_funds;
     }
 }
 
- void Account::print(std::ostream &os) const {
-    os.precision(2);
-    os << std::fixed;
-    os << "[Account: " << name << ": " << balance << "]";
+Expected<Money> Account::check_credit(Money amount) const {
+    if (amount < Money{})
+        return Account_Error::negative_transfer;
+    return balance + amount;
 }
 
-double Account::get_balance()
+bool Account::deposit(Money amount) {
+    return try_deposit(amount).has_value();
+}
+
+void Account::withdraw(Money amount) {
+    Expected<Money> result = try_withdraw(amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+void Account::format(Print_Buffer &buffer) const {
+    buffer.append("[Account: ").append(name).append(": ").append(balance).append(']');
+}
+
+Money Account::get_balance()
 {
     return balance;
 }
@@ -4,25 +4,42 @@
 #include <iostream>
 #include <string>
 #include "I_Printable.h"
+#include "Money.h"
+#include "Expected.h"
 #include "IllegalBalanceException.h"
 #include "InsufficientFundsException.h"
 
 class Account : public I_Printable {
+    friend class Account_Registry;    // indexes accounts by name without copying it
+    friend class Transfer_Engine;     // checks and applies the credit half of a transfer
 private:   
     static constexpr const char *def_name = "Unnamed Account";
-    static constexpr double def_balance = 0.0;
+    static constexpr Money def_balance = 0.0;
 protected:
     std::string name;
-    double balance;
+    Money balance;
+
+    // The balance after amount arrives by transfer - no interest, no bonus - without applying it.
+    // An account type that limits incoming money overrides this and returns the reason to reject;
+    // Transfer_Engine stores the result only once the source's withdrawal has gone through.
+    virtual Expected<Money> check_credit(Money amount) const;
 public:
-    Account(std::string name = def_name, double balance = def_balance);
-    virtual bool deposit(double amount) = 0;
-    virtual void withdraw(double amount) = 0;
-    virtual void print(std::ostream &os) const override;
+    Account(std::string name = def_name, Money balance = def_balance);
+
+    // Result-code API - returns the new balance, or the reason the transaction was rejected
+    virtual Expected<Money> try_deposit(Money amount) = 0;
+    virtual Expected<Money> try_withdraw(Money amount) = 0;
+
+    // Throwing API - thin wrappers over try_deposit / try_withdraw
+    bool deposit(Money amount);
+    void withdraw(Money amount);
+
+    virtual void format(Print_Buffer &buffer) const override;
     virtual ~Account() = default;
 
-    double get_balance();
+    Money get_balance();
     std::string get_name();
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef _ACCOUNT_ERROR_H_
+#define _ACCOUNT_ERROR_H_
+#include <exception>
+#include "IllegalBalanceException.h"
+#include "InsufficientFundsException.h"
+#include "IllegalTrustWithdrawalException.h"
+#include "DuplicateAccountException.h"
+#include "UnknownAccountException.h"
+
+// Why a transaction was rejected - the result-code twin of the exception classes
+enum class Account_Error : unsigned char {
+    illegal_balance,              // IllegalBalanceException
+    insufficient_funds,           // InsufficientFundsException
+    illegal_trust_withdrawal,     // IllegalTrustWithdrawalException
+    negative_deposit,             // deposit() returns false
+    duplicate_name,               // DuplicateAccountException - names are unique in an Account_Registry
+    unknown_account,              // UnknownAccountException - no account with that name or id
+    negative_transfer             // IllegalBalanceException - Transfer_Engine only moves positive amounts
+};
+
+inline const char *what(Account_Error error) {
+    switch (error) {
+        case Account_Error::illegal_balance:          return IllegalBalanceException().what();
+        case Account_Error::insufficient_funds:       return InsufficientFundsException().what();
+        case Account_Error::illegal_trust_withdrawal: return IllegalTrustWithdrawalException().what();
+        case Account_Error::negative_deposit:         return "Negative deposit";
+        case Account_Error::duplicate_name:           return DuplicateAccountException().what();
+        case Account_Error::unknown_account:          return UnknownAccountException().what();
+        case Account_Error::negative_transfer:        return "Negative transfer";
+    }
+    return "Unknown account error";
+}
+
+// Used by the throwing API to turn a result code back into its exception
+[[noreturn]] inline void throw_account_error(Account_Error error) {
+    switch (error) {
+        case Account_Error::insufficient_funds:       throw InsufficientFundsException();
+        case Account_Error::illegal_trust_withdrawal: throw IllegalTrustWithdrawalException();
+        case Account_Error::illegal_balance:
+        case Account_Error::negative_deposit:         throw IllegalBalanceException();
+        case Account_Error::duplicate_name:           throw DuplicateAccountException();
+        case Account_Error::unknown_account:          throw UnknownAccountException();
+        case Account_Error::negative_transfer:        throw IllegalBalanceException();
+    }
+    throw IllegalBalanceException();
+}
+
+#endif // _ACCOUNT_ERROR_H_
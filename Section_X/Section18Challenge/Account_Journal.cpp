@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Account_Journal.h"
+
+// On-disk format (host byte order, everything 8-byte aligned)
+//      group:      uint32 magic, uint32 payload bytes, uint64 checksum, then the records
+//      record:     uint64 kind << 56 | account id, int64 cents
+//      add record: followed by double int_rate, uint32 type, uint32 name length, name padded to 8
+//      snapshot:   uint32 magic, uint32 version, uint64 generation, uint64 accounts, uint64 checksum (of the
+//                  24 bytes before it and everything after it), then per account uint32 type,
+//                  int32 withdrawals, int64 cents, double int_rate, uint64 name length, name padded to 8
+static constexpr uint32_t group_magic = 0x4e524a41;          // "AJRN"
+static constexpr uint32_t snapshot_magic = 0x504e5341;       // "ASNP"
+static constexpr uint32_t snapshot_version = 2;
+static constexpr size_t group_header_size = 16;
+static constexpr size_t snapshot_header_size = 32;
+static constexpr size_t snapshot_record_size = 32;
+static constexpr size_t add_record_extra = 16;
+static constexpr size_t max_group_bytes = 64 << 20;
+static constexpr size_t snapshot_chunk_bytes = 1 << 20;     // snapshots are written a chunk at a time
+static constexpr int kind_shift = 56;
+static constexpr uint64_t id_mask = (uint64_t{1} << kind_shift) - 1;
+static constexpr uint64_t record_add = 1;
+static constexpr uint64_t record_deposit = 2;
+static constexpr uint64_t record_withdraw = 3;
+
+// FNV-1a over 8-byte words - cheap enough for a million records a second, and any torn or
+// half-written group fails it. Pass the previous result as hash to continue over a second range
+static uint64_t checksum(const char *data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+static void put(std::vector<char> &buffer, const T &value) {
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T get(const char *data, size_t &pos) {
+    T value;
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+static void put_name(std::vector<char> &buffer, const std::string &name) {
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    buffer.resize(buffer.size() + (8 - name.size() % 8) % 8, '\0');
+}
+
+static size_t padded(size_t size) {
+    return size + (8 - size % 8) % 8;
+}
+
+static void write_all(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            throw JournalIOException();
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+// fdatasync where there is one. macOS has none, and its fsync only reaches the drive's cache, so
+// there it takes F_FULLFSYNC
+static bool sync_file(int fd) {
+#ifdef __APPLE__
+    return ::fcntl(fd, F_FULLFSYNC) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+// Closes the descriptor on every way out of a scope, unless release() hands it on
+struct File_Guard {
+    int fd;
+    explicit File_Guard(int fd) : fd {fd} {}
+    File_Guard(const File_Guard &) = delete;
+    File_Guard &operator=(const File_Guard &) = delete;
+    ~File_Guard() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+    int release() {
+        int released = fd;
+        fd = -1;
+        return released;
+    }
+};
+
+// Returns fewer than size bytes only at end of file
+static size_t read_full(int fd, char *data, size_t size) {
+    size_t total {0};
+    while (total < size) {
+        ssize_t got = ::read(fd, data + total, size - total);
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            throw JournalIOException();
+        }
+        if (got == 0)
+            break;
+        total += static_cast<size_t>(got);
+    }
+    return total;
+}
+
+// Makes a create / rename / unlink in the directory itself durable
+static void sync_directory(const std::string &directory) {
+    File_Guard dir {::open(directory.c_str(), O_RDONLY | O_DIRECTORY)};
+    if (dir.fd < 0 || ::fsync(dir.fd) != 0)
+        throw JournalIOException();
+}
+
+Account_Journal::Account_Journal(std::string directory, size_t group_size, size_t snapshot_interval)
+    : directory {directory}, group_size {group_size > 0 ? group_size : 1}, snapshot_interval {snapshot_interval},
+      generation {0}, log_fd {-1}, poisoned {false}, pending(group_header_size), pending_records {0},
+      records_since_snapshot {0}, recovery {0, 0, 0, 0.0} {
+        auto start = std::chrono::steady_clock::now();
+        if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw JournalIOException();
+        load_snapshot();
+        try {
+            replay_log();
+        }
+        catch (...) {
+            if (log_fd >= 0)                // no destructor runs for a constructor that throws
+                ::close(log_fd);
+            throw;
+        }
+        recovery.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Account_Journal::~Account_Journal() {
+    try {
+        commit();
+    }
+    catch (const JournalIOException &) {
+    }
+    if (log_fd >= 0)
+        ::close(log_fd);
+}
+
+std::string Account_Journal::log_path(uint64_t gen) const {
+    return directory + "/journal." + std::to_string(gen) + ".log";
+}
+
+std::string Account_Journal::snapshot_path() const {
+    return directory + "/snapshot.bin";
+}
+
+// Recovery
+
+void Account_Journal::load_snapshot() {
+    File_Guard file {::open(snapshot_path().c_str(), O_RDONLY)};
+    if (file.fd < 0) {
+        if (errno == ENOENT)
+            return;                         // no snapshot yet: everything is in journal 0
+        throw JournalIOException();
+    }
+    struct stat info;
+    if (::fstat(file.fd, &info) != 0)
+        throw JournalIOException();
+    std::vector<char> data(static_cast<size_t>(info.st_size));
+    size_t got = read_full(file.fd, data.data(), data.size());
+
+    // A snapshot is only ever renamed into place complete, so a bad one is real damage, not a crash
+    size_t pos {0};
+    if (got != data.size() || data.size() < snapshot_header_size
+            || get<uint32_t>(data.data(), pos) != snapshot_magic || get<uint32_t>(data.data(), pos) != snapshot_version)
+        throw JournalIOException();
+    uint64_t snapshot_generation = get<uint64_t>(data.data(), pos);
+    uint64_t accounts = get<uint64_t>(data.data(), pos);
+    uint64_t expected_checksum = get<uint64_t>(data.data(), pos);
+    uint64_t header_checksum = checksum(data.data(), snapshot_header_size - 8);
+    if (checksum(data.data() + pos, data.size() - pos, header_checksum) != expected_checksum
+            || accounts > (data.size() - pos) / snapshot_record_size)
+        throw JournalIOException();
+
+    ledger.reserve(accounts);
+    for (uint64_t i = 0; i < accounts; i++) {
+        if (data.size() - pos < snapshot_record_size)
+            throw JournalIOException();
+        Account_Type type = static_cast<Account_Type>(get<uint32_t>(data.data(), pos));
+        int withdrawals = get<int32_t>(data.data(), pos);
+        long long cents = get<int64_t>(data.data(), pos);
+        double int_rate = get<double>(data.data(), pos);
+        size_t name_length = get<uint64_t>(data.data(), pos);
+        if (name_length > data.size() - pos)
+            throw JournalIOException();
+        size_t id = ledger.add(type, std::string(data.data() + pos, name_length), Money::from_cents(cents), int_rate);
+        ledger.num_withdrawals[id] = withdrawals;
+        pos = std::min(pos + padded(name_length), data.size());
+    }
+    if (pos != data.size())
+        throw JournalIOException();
+    generation = snapshot_generation;
+    recovery.snapshot_accounts = accounts;
+}
+
+// Applies every complete group of the current journal; a torn or damaged group (and anything
+// after it) is the crash that interrupted a commit, so it is cut off and appending resumes there
+void Account_Journal::replay_log() {
+    log_fd = ::open(log_path(generation).c_str(), O_RDWR | O_CREAT, 0644);
+    if (log_fd < 0)
+        throw JournalIOException();
+    off_t file_size = ::lseek(log_fd, 0, SEEK_END);
+    ::lseek(log_fd, 0, SEEK_SET);
+
+    off_t offset {0};
+    std::vector<char> group;
+    while (true) {
+        char header[group_header_size];
+        if (read_full(log_fd, header, group_header_size) != group_header_size)
+            break;
+        size_t pos {0};
+        uint32_t magic = get<uint32_t>(header, pos);
+        uint32_t bytes = get<uint32_t>(header, pos);
+        uint64_t expected_checksum = get<uint64_t>(header, pos);
+        if (magic != group_magic || bytes > max_group_bytes || bytes % 8 != 0)
+            break;
+        group.resize(bytes);
+        if (read_full(log_fd, group.data(), bytes) != bytes || checksum(group.data(), bytes) != expected_checksum)
+            break;
+
+        pos = 0;
+        while (pos + 16 <= bytes) {
+            uint64_t kind_and_id = get<uint64_t>(group.data(), pos);
+            Money amount = Money::from_cents(get<int64_t>(group.data(), pos));
+            uint64_t kind = kind_and_id >> kind_shift;
+            size_t id = kind_and_id & id_mask;
+            if (kind == record_add) {
+                if (bytes - pos < add_record_extra)
+                    throw JournalIOException();
+                double int_rate = get<double>(group.data(), pos);
+                Account_Type type = static_cast<Account_Type>(get<uint32_t>(group.data(), pos));
+                size_t name_length = get<uint32_t>(group.data(), pos);
+                if (id != ledger.size() || name_length > bytes - pos)
+                    throw JournalIOException();
+                ledger.add(type, std::string(group.data() + pos, name_length), amount, int_rate);
+                pos = std::min(pos + padded(name_length), size_t {bytes});
+            } else if (id < ledger.size() && kind == record_deposit) {
+                ledger.try_deposit(id, amount);
+            } else if (id < ledger.size() && kind == record_withdraw) {
+                ledger.try_withdraw(id, amount);
+            } else {
+                throw JournalIOException();
+            }
+            recovery.replayed++;
+        }
+        offset += static_cast<off_t>(group_header_size + bytes);
+    }
+    records_since_snapshot = recovery.replayed;
+
+    if (offset != file_size) {
+        recovery.discarded_bytes = static_cast<size_t>(file_size - offset);
+        if (::ftruncate(log_fd, offset) != 0 || !sync_file(log_fd))
+            throw JournalIOException();
+    }
+    ::lseek(log_fd, offset, SEEK_SET);
+    if (file_size == 0)
+        sync_directory(directory);          // the journal may have just been created
+}
+
+// Writing
+
+void Account_Journal::append(uint64_t kind, size_t id, long long cents) {
+    put<uint64_t>(pending, kind << kind_shift | id);
+    put<int64_t>(pending, cents);
+}
+
+void Account_Journal::record_written() {
+    pending_records++;
+    records_since_snapshot++;
+    if (pending_records >= group_size)
+        commit();
+    if (snapshot_interval > 0 && records_since_snapshot >= snapshot_interval)
+        snapshot();
+}
+
+// Refuses every write once the journal is poisoned, before the ledger is touched
+void Account_Journal::check_usable() const {
+    if (poisoned)
+        throw JournalIOException();
+}
+
+size_t Account_Journal::add(Account_Type type, std::string name, Money balance, double int_rate) {
+    check_usable();
+    size_t id = ledger.add(type, name, balance, int_rate);       // throws before anything is logged
+    append(record_add, id, balance.get_cents());
+    put<double>(pending, ledger.get_int_rate(id));
+    put<uint32_t>(pending, static_cast<uint32_t>(type));
+    put<uint32_t>(pending, static_cast<uint32_t>(name.size()));
+    put_name(pending, name);
+    record_written();
+    return id;
+}
+
+// Only transactions that changed something are logged: a rejected deposit changes nothing, and a
+// rejected withdrawal only counts against a trust's allowance when it fails for lack of funds
+Expected<Money> Account_Journal::try_deposit(size_t id, Money amount) {
+    check_usable();
+    Expected<Money> result = ledger.try_deposit(id, amount);
+    if (result) {
+        append(record_deposit, id, amount.get_cents());
+        record_written();
+    }
+    return result;
+}
+
+Expected<Money> Account_Journal::try_withdraw(size_t id, Money amount) {
+    check_usable();
+    Expected<Money> result = ledger.try_withdraw(id, amount);
+    if (result || (ledger.get_type(id) == Account_Type::trust && result.error() == Account_Error::insufficient_funds)) {
+        append(record_withdraw, id, amount.get_cents());
+        record_written();
+    }
+    return result;
+}
+
+bool Account_Journal::deposit(size_t id, Money amount) {
+    return try_deposit(id, amount).has_value();
+}
+
+void Account_Journal::withdraw(size_t id, Money amount) {
+    Expected<Money> result = try_withdraw(id, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+// Group commit: one write and one sync for every record since the last commit. If either fails,
+// the transactions in the group are already in the ledger but not on disk, so the journal is
+// poisoned; the log is still cut back to the last committed group, so reopening the directory
+// recovers everything up to there
+void Account_Journal::commit() {
+    check_usable();
+    if (pending_records == 0)
+        return;
+    size_t bytes = pending.size() - group_header_size;
+    uint32_t magic = group_magic;
+    uint32_t length = static_cast<uint32_t>(bytes);
+    uint64_t sum = checksum(pending.data() + group_header_size, bytes);
+    std::memcpy(pending.data(), &magic, 4);
+    std::memcpy(pending.data() + 4, &length, 4);
+    std::memcpy(pending.data() + 8, &sum, 8);
+    off_t committed = ::lseek(log_fd, 0, SEEK_CUR);
+    try {
+        if (committed < 0)
+            throw JournalIOException();
+        write_all(log_fd, pending.data(), pending.size());
+        if (!sync_file(log_fd))
+            throw JournalIOException();
+    }
+    catch (const JournalIOException &) {
+        poisoned = true;
+        if (committed >= 0 && ::ftruncate(log_fd, committed) == 0)
+            ::lseek(log_fd, committed, SEEK_SET);
+        throw;
+    }
+    pending.resize(group_header_size);
+    pending_records = 0;
+}
+
+// Writes the ledger to snapshot.tmp, starts journal g+1, and only then renames the snapshot into
+// place: a crash before the rename recovers from the old snapshot and journal g, a crash after it
+// from the new snapshot and the (empty) journal g+1. A failure poisons the journal, since after the
+// rename new records would go to a journal that recovery no longer reads.
+void Account_Journal::snapshot() {
+    commit();
+    try {
+        write_snapshot();
+    }
+    catch (const JournalIOException &) {
+        poisoned = true;
+        throw;
+    }
+}
+
+// The body goes out in chunks of about snapshot_chunk_bytes (records are 8-byte multiples, so the
+// checksum carries across chunks), then the header is rewritten with the checksum
+void Account_Journal::write_snapshot() {
+    std::string temp_path = snapshot_path() + ".tmp";
+    File_Guard file {::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+    if (file.fd < 0)
+        throw JournalIOException();
+    std::vector<char> header;
+    put<uint32_t>(header, snapshot_magic);
+    put<uint32_t>(header, snapshot_version);
+    put<uint64_t>(header, generation + 1);
+    put<uint64_t>(header, ledger.size());
+    uint64_t sum = checksum(header.data(), header.size());
+    put<uint64_t>(header, 0);
+    write_all(file.fd, header.data(), header.size());
+
+    std::vector<char> chunk;
+    chunk.reserve(snapshot_chunk_bytes + 256);
+    for (size_t id = 0; id < ledger.size(); id++) {
+        const std::string &name = ledger.get_name(id);
+        put<uint32_t>(chunk, static_cast<uint32_t>(ledger.get_type(id)));
+        put<int32_t>(chunk, ledger.get_num_withdrawals(id));
+        put<int64_t>(chunk, ledger.get_balance(id).get_cents());
+        put<double>(chunk, ledger.get_int_rate(id));
+        put<uint64_t>(chunk, name.size());
+        put_name(chunk, name);
+        if (chunk.size() >= snapshot_chunk_bytes || id + 1 == ledger.size()) {
+            sum = checksum(chunk.data(), chunk.size(), sum);
+            write_all(file.fd, chunk.data(), chunk.size());
+            chunk.clear();
+        }
+    }
+    std::memcpy(header.data() + snapshot_header_size - 8, &sum, 8);
+    if (::pwrite(file.fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size())
+            || !sync_file(file.fd))
+        throw JournalIOException();
+
+    File_Guard next {::open(log_path(generation + 1).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (next.fd < 0 || !sync_file(next.fd))
+        throw JournalIOException();
+    if (::rename(temp_path.c_str(), snapshot_path().c_str()) != 0)
+        throw JournalIOException();
+    sync_directory(directory);
+
+    ::close(log_fd);
+    ::unlink(log_path(generation).c_str());
+    log_fd = next.release();
+    generation++;
+    records_since_snapshot = 0;
+}
+
+// getters
+const Account_Ledger &Account_Journal::get_ledger() const { return ledger; }
+const Recovery_Report &Account_Journal::get_recovery() const { return recovery; }
+uint64_t Account_Journal::get_generation() const { return generation; }
+size_t Account_Journal::get_pending() const { return pending_records; }
+bool Account_Journal::is_poisoned() const { return poisoned; }
@@ -0,0 +1,84 @@
+#ifndef _ACCOUNT_JOURNAL_H_
+#define _ACCOUNT_JOURNAL_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Account_Ledger.h"
+#include "JournalIOException.h"
+
+// What the constructor found on disk
+struct Recovery_Report {
+    size_t snapshot_accounts;      // accounts loaded from the snapshot
+    size_t replayed;               // journal records applied on top of it
+    size_t discarded_bytes;        // torn last group from a crash mid-write, cut off the log
+    double seconds;
+};
+
+// Durable Account_Ledger: write-ahead journal + snapshots
+// Every add / deposit / withdraw is applied to the ledger and appended to the journal as a 16-byte
+// record (names and rates ride along with add). Records are grouped: a group is written with one
+// write() and one sync (fdatasync, or F_FULLFSYNC on macOS) when group_size records are waiting, or
+// when commit() is called, and is framed by a header with its length and checksum so a group torn by
+// a crash is detected and dropped on recovery. Every snapshot_interval records (0 = only on request) the whole ledger is
+// written to a snapshot and a new, empty journal is started.
+//
+// Files in the directory:
+//      snapshot.bin        ledger as of the start of journal generation g (absent before the first snapshot)
+//      journal.<g>.log     records since then
+//
+// Recovery (in the constructor) loads the snapshot, replays journal g through the ledger's own
+// transaction functions, and keeps appending to it. Transactions are durable once commit() returns.
+//
+// Transactions are applied to the ledger before they are logged, so when a commit or snapshot fails
+// (JournalIOException, possibly from the add / deposit / withdraw that filled a group) the ledger
+// holds transactions that may not be on disk. The journal is then poisoned: every later write and
+// commit throws JournalIOException without touching the ledger, and get_ledger() may be ahead of the
+// disk. Reopening the directory recovers the last durable state.
+class Account_Journal
+{
+private:
+    std::string directory;
+    size_t group_size;
+    size_t snapshot_interval;
+    Account_Ledger ledger;
+    uint64_t generation;
+    int log_fd;
+    bool poisoned;                          // a commit or snapshot failed: every write now throws
+    std::vector<char> pending;              // open group: header space + records
+    size_t pending_records;
+    size_t records_since_snapshot;
+    Recovery_Report recovery;
+
+    std::string log_path(uint64_t gen) const;
+    std::string snapshot_path() const;
+    void load_snapshot();
+    void replay_log();
+    void open_log();
+    void append(uint64_t kind, size_t id, long long cents);
+    void record_written();
+    void check_usable() const;
+    void write_snapshot();
+public:
+    explicit Account_Journal(std::string directory, size_t group_size = 4096, size_t snapshot_interval = 0);
+    Account_Journal(const Account_Journal &) = delete;
+    Account_Journal &operator=(const Account_Journal &) = delete;
+    ~Account_Journal();                     // commits what is pending
+
+    size_t add(Account_Type type, std::string name, Money balance = 0.0, double int_rate = 0.0);
+    Expected<Money> try_deposit(size_t id, Money amount);
+    Expected<Money> try_withdraw(size_t id, Money amount);
+    bool deposit(size_t id, Money amount);
+    void withdraw(size_t id, Money amount);
+
+    void commit();                          // everything so far survives a crash once this returns
+    void snapshot();
+
+    const Account_Ledger &get_ledger() const;
+    const Recovery_Report &get_recovery() const;
+    uint64_t get_generation() const;
+    size_t get_pending() const;
+    bool is_poisoned() const;
+};
+
+#endif // _ACCOUNT_JOURNAL_H_
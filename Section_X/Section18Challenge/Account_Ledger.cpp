@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include "Account_Ledger.h"
+#include "Checking_Account.h"
+#include "Savings_Account.h"
+#include "Trust_Account.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Interest kernel
+// Compounds accounts [begin, end) and returns the interest credited in cents. Every account gets
+// exactly Savings_Account::accrue_interest: nearest_cents(cents * factor). In the SIMD loops cents are
+// moved between int64 and double with the 2^52 trick - OR-ing the integer into the mantissa of 2^52
+// converts it, and adding 2^52 to a double rounds it (ties to even) and leaves the integer in the low
+// bits - which is exact while balances stay below 2^50 cents. A group holding anything outside that
+// range (or a negative rate) is redone by the scalar code. Checking accounts keep their balance.
+static long long accrue_one(const Account_Type *type_p, long long *balance_p, const double *rate_p,
+                            size_t i, double periods) {
+    if (type_p[i] == Account_Type::checking)
+        return 0;
+    long long updated = Money::nearest_cents(balance_p[i] * (1.0 + (rate_p[i]/100.0)/periods));
+    long long interest = updated - balance_p[i];
+    balance_p[i] = updated;
+    return interest;
+}
+
+static long long accrue_range(const Account_Type *type_p, long long *balance_p, const double *rate_p,
+                              size_t begin, size_t end, double periods) {
+    long long cents {0};
+    size_t i = begin;
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr long long exact_limit = 1LL << 50;
+    constexpr double grown_limit = 2251799813685248.0;             // 2^51
+#endif
+#if defined(__AVX2__)
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d per = _mm256_set1_pd(periods);
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0);     // 2^52
+    const __m256i magic_bits = _mm256_castpd_si256(magic);
+    const __m256i out_of_range = _mm256_set1_epi64x(~(exact_limit - 1));
+    const __m256i checking = _mm256_set1_epi64x(static_cast<long long>(Account_Type::checking));
+    __m256i interest = _mm256_setzero_si256();
+    for (; i + 4 <= end; i += 4) {
+        __m256i balance = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(balance_p + i));
+        __m256d rate = _mm256_loadu_pd(rate_p + i);
+        __m256d b = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(balance, magic_bits)), magic);
+        __m256d grown = _mm256_mul_pd(b, _mm256_add_pd(one, _mm256_div_pd(_mm256_div_pd(rate, hundred), per)));
+        int in_range = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(grown, _mm256_setzero_pd(), _CMP_GE_OQ),
+                                                        _mm256_cmp_pd(grown, _mm256_set1_pd(grown_limit), _CMP_LT_OQ)));
+        if (!_mm256_testz_si256(balance, out_of_range) || in_range != 0xF) {
+            for (size_t j = i; j < i + 4; j++)
+                cents += accrue_one(type_p, balance_p, rate_p, j, periods);
+            continue;
+        }
+        int packed;
+        std::memcpy(&packed, type_p + i, 4);
+        __m256i is_checking = _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed)), checking);
+
+        __m256i updated = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(grown, magic)), magic_bits);
+        updated = _mm256_blendv_epi8(updated, balance, is_checking);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(balance_p + i), updated);
+        interest = _mm256_add_epi64(interest, _mm256_sub_epi64(updated, balance));
+    }
+    long long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), interest);
+    cents += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d hundred = _mm_set1_pd(100.0);
+    const __m128d per = _mm_set1_pd(periods);
+    const __m128d magic = _mm_set1_pd(4503599627370496.0);        // 2^52
+    const __m128i magic_bits = _mm_castpd_si128(magic);
+    __m128i interest = _mm_setzero_si128();
+    for (; i + 2 <= end; i += 2) {
+        __m128i balance = _mm_loadu_si128(reinterpret_cast<const __m128i *>(balance_p + i));
+        __m128d rate = _mm_loadu_pd(rate_p + i);
+        __m128d b = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(balance, magic_bits)), magic);
+        __m128d grown = _mm_mul_pd(b, _mm_add_pd(one, _mm_div_pd(_mm_div_pd(rate, hundred), per)));
+        int in_range = _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(grown, _mm_setzero_pd()),
+                                                  _mm_cmplt_pd(grown, _mm_set1_pd(grown_limit))));
+        if (static_cast<unsigned long long>(balance_p[i] | balance_p[i + 1]) >= static_cast<unsigned long long>(exact_limit)
+                || in_range != 0x3) {
+            cents += accrue_one(type_p, balance_p, rate_p, i, periods);
+            cents += accrue_one(type_p, balance_p, rate_p, i + 1, periods);
+            continue;
+        }
+        __m128i accrues = _mm_set_epi64x(-static_cast<long long>(type_p[i + 1] != Account_Type::checking),
+                                         -static_cast<long long>(type_p[i] != Account_Type::checking));
+        __m128i updated = _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(grown, magic)), magic_bits);
+        updated = _mm_or_si128(_mm_and_si128(accrues, updated), _mm_andnot_si128(accrues, balance));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(balance_p + i), updated);
+        interest = _mm_add_epi64(interest, _mm_sub_epi64(updated, balance));
+    }
+    long long lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), interest);
+    cents += lanes[0] + lanes[1];
+#endif
+    // Scalar tail (and the whole range on targets without SSE2)
+    for (; i < end; i++)
+        cents += accrue_one(type_p, balance_p, rate_p, i, periods);
+    return cents;
+}
+
+// Indexed by Account_Type
+const Compiled_Policy &rules_for(Account_Type type) {
+    static constexpr const Compiled_Policy *rules[] {&Checking_Account::rules, &Savings_Account::rules,
+                                                     &Trust_Account::rules};
+    return *rules[static_cast<int>(type)];
+}
+
+Account_Ledger::Account_Ledger()
+    : type_counts{0, 0, 0}, balance_ceiling {0}, max_int_rate {0.0}, epoch_changes(1),
+      bulk_epochs{no_epoch, no_epoch, no_epoch} {
+}
+
+void Account_Ledger::reserve(size_t count) {
+    ids.reserve(count);
+    types.reserve(count);
+    balances.reserve(count);
+    int_rates.reserve(count);
+    num_withdrawals.reserve(count);
+    names.reserve(count);
+    changed_epochs.reserve(count);
+}
+
+// Same check as the Account constructor
+size_t Account_Ledger::add(Account_Type type, std::string name, Money balance, double int_rate) {
+    if (balance < Money{})
+        throw IllegalBalanceException();
+    size_t id = ids.size();
+    ids.push_back(id);
+    types.push_back(type);
+    balances.push_back(balance.get_cents());
+    int_rates.push_back(type == Account_Type::checking ? 0.0 : int_rate);
+    num_withdrawals.push_back(0);
+    names.push_back(std::move(name));
+    changed_epochs.push_back(no_epoch);
+    mark_changed(id, epoch_changes.back());
+    type_counts[static_cast<int>(type)]++;
+    raise_ceiling(balance);
+    if (int_rates.back() > max_int_rate)
+        max_int_rate = int_rates.back();
+    return id;
+}
+
+// Balance ceiling
+// No balance is ever above balance_ceiling, so a batch that fits under Money's range when applied to
+// the ceiling fits for every account: the check is one overflow-checked Money sum before the loop
+// (which throws MoneyOverflowException with the ledger untouched), and the loops themselves can use
+// plain int64 adds that vectorize.
+void Account_Ledger::raise_ceiling(Money balance) {
+    if (balance.get_cents() > balance_ceiling)
+        balance_ceiling = balance.get_cents();
+}
+
+// One account
+
+// Checking_Account::try_deposit / Savings_Account::try_deposit / Trust_Account::try_deposit
+Expected<Money> Account_Ledger::try_deposit(size_t id, Money amount) {
+    return try_deposit(id, amount, balance_ceiling, epoch_changes.back());
+}
+
+Expected<Money> Account_Ledger::try_deposit(size_t id, Money amount, long long &ceiling,
+                                            std::vector<size_t> &changed) {
+    Money balance = Money::from_cents(balances[id]);
+    Expected<Money> result = rules_for(types[id]).deposit(balance, amount, int_rates[id]);
+    if (!result)
+        return result;
+    Money updated = result.value();
+    balances[id] = updated.get_cents();
+    if (updated.get_cents() > ceiling)
+        ceiling = updated.get_cents();
+    if (updated != balance)
+        mark_changed(id, changed);
+    return updated;
+}
+
+// Checking_Account::try_withdraw / Savings_Account::try_withdraw / Trust_Account::try_withdraw
+Expected<Money> Account_Ledger::try_withdraw(size_t id, Money amount) {
+    return try_withdraw(id, amount, balance_ceiling, epoch_changes.back());
+}
+
+Expected<Money> Account_Ledger::try_withdraw(size_t id, Money amount, long long &ceiling,
+                                             std::vector<size_t> &changed) {
+    Money balance = Money::from_cents(balances[id]);
+    Expected<Money> result = rules_for(types[id]).withdraw(balance, num_withdrawals[id], amount);
+    if (!result)
+        return result;
+    Money updated = result.value();
+    balances[id] = updated.get_cents();
+    if (updated.get_cents() > ceiling)
+        ceiling = updated.get_cents();
+    if (updated != balance)
+        mark_changed(id, changed);
+    return updated;
+}
+
+bool Account_Ledger::deposit(size_t id, Money amount) {
+    return try_deposit(id, amount).has_value();
+}
+
+void Account_Ledger::withdraw(size_t id, Money amount) {
+    Expected<Money> result = try_withdraw(id, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+// Every account of one type
+// Each loop body is straight-line code: accounts of other types (or rejected transactions) get an
+// amount of 0 instead of a branch around the update, and conditions are combined with & rather than
+// &&, so the compiler can turn the loops into SIMD code (build with -O3 or -ftree-vectorize). With
+// balances in cents every check is an integer compare.
+
+Batch_Result Account_Ledger::deposit_all(Account_Type type, Money amount) {
+    size_t n = balances.size();
+    const Account_Type *type_p = types.data();
+    long long *balance_p = balances.data();
+    const double *rate_p = int_rates.data();
+    size_t total = count(type);
+    const Compiled_Policy &rules = rules_for(type);
+
+    if (amount >= rules.bonus_threshold)
+        amount += rules.deposit_bonus;
+    if (amount < Money{})
+        return Batch_Result{0, total};
+    long long cents = amount.get_cents();
+    bulk_epochs[static_cast<int>(type)] = get_epoch();
+
+    if (rules.interest_on == 0) {
+        raise_ceiling(Money::from_cents(balance_ceiling) + amount);
+        for (size_t i = 0; i < n; i++)
+            balance_p[i] += (type_p[i] == type) ? cents : 0;
+        return Batch_Result{total, 0};
+    }
+
+    // Products with interest: each account adds its own interest bonus, rounded to the cent as in
+    // Compiled_Policy::deposit. The ceiling check already proved every bonus is in range, so the loop
+    // rounds with nearbyint (same ties-to-even rule as Money::nearest_cents) instead of a checked call.
+    raise_ceiling(Money::from_cents(balance_ceiling) + amount + amount.scaled(max_int_rate/100));
+    for (size_t i = 0; i < n; i++) {
+        long long selected = (type_p[i] == type) ? cents : 0;     // select first, so no math is done under a condition
+        balance_p[i] += selected + static_cast<long long>(std::nearbyint(selected * (rate_p[i]/100)));
+    }
+    return Batch_Result{total, 0};
+}
+
+Batch_Result Account_Ledger::withdraw_all(Account_Type type, Money amount) {
+    size_t n = balances.size();
+    const Account_Type *type_p = types.data();
+    long long *balance_p = balances.data();
+    int *withdrawals_p = num_withdrawals.data();
+    size_t succeeded {0};
+    const Compiled_Policy &rules = rules_for(type);
+
+    amount += rules.withdrawal_fee;
+    if (rules.capped)        // then no balance * percent in the loop can overflow either
+        (void)(Money::from_cents(balance_ceiling) * rules.max_withdraw_percent);
+    if (amount < Money{})
+        raise_ceiling(Money::from_cents(balance_ceiling) - amount);
+    long long cents = amount.get_cents();
+    bulk_epochs[static_cast<int>(type)] = get_epoch();
+
+    if (rules.capped || rules.counted) {
+        long long scaled_amount = (amount * 100).get_cents();      // amount * 100 > balance * percent, as in the policy
+        int max_withdrawals = rules.max_withdrawals;
+        int percent = rules.max_withdraw_percent;
+        bool capped = rules.capped;
+        int counted = rules.counted;
+        for (size_t i = 0; i < n; i++) {
+            long long balance = balance_p[i];
+            bool allowed = (type_p[i] == type)
+                & (withdrawals_p[i] < max_withdrawals)
+                & !(capped & (scaled_amount > balance * percent));
+            withdrawals_p[i] += allowed & counted;      // counted even if the balance check below fails
+            bool ok = allowed & (balance - cents >= 0);
+            balance_p[i] = ok ? balance - cents : balance;
+            succeeded += ok;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            long long balance = balance_p[i];
+            bool ok = (type_p[i] == type) & (balance - cents >= 0);
+            balance_p[i] = ok ? balance - cents : balance;
+            succeeded += ok;
+        }
+    }
+    return Batch_Result{succeeded, count(type) - succeeded};
+}
+
+// Interest for the whole ledger
+Accrual_Report Account_Ledger::accrue_interest(int periods_per_year, unsigned int threads) {
+    constexpr size_t chunk_size = 64 * 1024;
+    auto start = std::chrono::steady_clock::now();
+
+    size_t n = balances.size();
+    size_t chunk_count = (n + chunk_size - 1) / chunk_size;
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    if (threads > chunk_count)
+        threads = chunk_count > 0 ? static_cast<unsigned int>(chunk_count) : 1;
+
+    // A ceiling that would overflow throws here, before any balance changes
+    double factor = 1.0 + (max_int_rate/100.0)/periods_per_year;
+    raise_ceiling(Money::from_cents(balance_ceiling).scaled(factor > 1.0 ? factor : 1.0));
+    bulk_epochs[static_cast<int>(Account_Type::savings)] = get_epoch();
+    bulk_epochs[static_cast<int>(Account_Type::trust)] = get_epoch();
+
+    std::vector<long long> chunk_cents(chunk_count, 0);
+    const Account_Type *type_p = types.data();
+    long long *balance_p = balances.data();
+    const double *rate_p = int_rates.data();
+    double periods = periods_per_year;
+
+    // Worker t owns a contiguous run of chunks, so no two threads ever touch the same cache line
+    auto work = [&](unsigned int t) {
+        size_t first = chunk_count * t / threads;
+        size_t last = chunk_count * (t + 1) / threads;
+        for (size_t c = first; c < last; c++) {
+            size_t begin = c * chunk_size;
+            size_t end = begin + chunk_size < n ? begin + chunk_size : n;
+            chunk_cents[c] = accrue_range(type_p, balance_p, rate_p, begin, end, periods);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; t++)
+        workers.emplace_back(work, t);
+    work(0);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    long long total_cents {0};
+    for (long long cents : chunk_cents)
+        total_cents += cents;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t accounts = count(Account_Type::savings) + count(Account_Type::trust);
+    return Accrual_Report{accounts, Money::from_cents(total_cents), threads, seconds, seconds > 0 ? accounts / seconds : 0.0};
+}
+
+// Incremental statements
+
+unsigned int Account_Ledger::begin_epoch() {
+    epoch_changes.emplace_back();
+    return get_epoch();
+}
+
+unsigned int Account_Ledger::get_epoch() const { return static_cast<unsigned int>(epoch_changes.size() - 1); }
+
+// An id sits in the list of every epoch it changed in, but only the entry for its latest epoch is
+// reported, so each account comes out once
+std::vector<Balance_Change> Account_Ledger::changes_since(unsigned int epoch) const {
+    std::vector<Balance_Change> changes;
+    bool bulk[3];
+    bool any_bulk = false;
+    for (int type = 0; type < 3; type++) {
+        bulk[type] = bulk_epochs[type] != no_epoch && bulk_epochs[type] >= epoch;
+        any_bulk |= bulk[type];
+    }
+    for (size_t e = epoch; e < epoch_changes.size(); e++)
+        for (size_t id : epoch_changes[e])
+            if (changed_epochs[id] == e && !bulk[static_cast<int>(types[id])])
+                changes.push_back(Balance_Change{id, Money::from_cents(balances[id])});
+    if (any_bulk) {
+        for (size_t id = 0; id < types.size(); id++)
+            if (bulk[static_cast<int>(types[id])])
+                changes.push_back(Balance_Change{id, Money::from_cents(balances[id])});
+    }
+    std::sort(changes.begin(), changes.end(),
+              [](const Balance_Change &a, const Balance_Change &b) { return a.id < b.id; });
+    return changes;
+}
+
+// getters
+size_t Account_Ledger::size() const { return ids.size(); }
+size_t Account_Ledger::count(Account_Type type) const { return type_counts[static_cast<int>(type)]; }
+size_t Account_Ledger::get_id(size_t idx) const { return ids[idx]; }
+Account_Type Account_Ledger::get_type(size_t id) const { return types[id]; }
+Money Account_Ledger::get_balance(size_t id) const { return Money::from_cents(balances[id]); }
+double Account_Ledger::get_int_rate(size_t id) const { return int_rates[id]; }
+int Account_Ledger::get_num_withdrawals(size_t id) const { return num_withdrawals[id]; }
+const std::string &Account_Ledger::get_name(size_t id) const { return names[id]; }
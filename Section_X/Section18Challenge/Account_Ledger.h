@@ -0,0 +1,124 @@
+#ifndef _ACCOUNT_LEDGER_H_
+#define _ACCOUNT_LEDGER_H_
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Money.h"
+#include "Expected.h"
+#include "Account_Policy.h"
+#include "IllegalBalanceException.h"
+#include "InsufficientFundsException.h"
+#include "IllegalTrustWithdrawalException.h"
+
+enum class Account_Type : unsigned char {
+    checking,
+    savings,
+    trust
+};
+
+// The compiled rules of one account type (Checking_Account::rules and so on)
+const Compiled_Policy &rules_for(Account_Type type);
+
+// Outcome of applying one transaction to a batch of accounts
+struct Batch_Result {
+    size_t succeeded;
+    size_t failed;
+};
+
+// Outcome of one interest run over the ledger
+struct Accrual_Report {
+    size_t accounts;               // savings and trust accounts that were compounded
+    Money interest;                // total interest credited
+    unsigned int threads;
+    double seconds;
+    double accounts_per_second;
+};
+
+// One account in a statement: its balance at the time changes_since() was called
+struct Balance_Change {
+    size_t id;
+    Money balance;
+};
+
+// Columnar (structure-of-arrays) store for large books of accounts
+// Each field lives in its own contiguous array indexed by account id, so a batch operation over all
+// accounts of one type is a single branch-free pass the compiler can vectorize, instead of one virtual
+// call per heap object. The rules are the same as Checking_Account, Savings_Account and Trust_Account.
+class Account_Ledger
+{
+    friend class Account_Journal;     // restores trust withdrawal counts from snapshots
+    friend class Transaction_Processor;   // runs one-account transactions on worker threads
+private:
+    std::vector<size_t> ids;
+    std::vector<Account_Type> types;
+    std::vector<long long> balances;       // cents
+    std::vector<double> int_rates;         // percent, 0 for checking accounts
+    std::vector<int> num_withdrawals;      // only used by trust accounts
+    std::vector<std::string> names;        // cold data, kept out of the hot arrays
+    size_t type_counts[3];
+    long long balance_ceiling;             // no balance is above this (cents)
+    double max_int_rate;
+
+    // Change tracking, see begin_epoch()
+    static constexpr unsigned int no_epoch = static_cast<unsigned int>(-1);
+    std::vector<unsigned int> changed_epochs;              // epoch of each account's last balance change
+    std::vector<std::vector<size_t>> epoch_changes;        // ids first changed in each epoch
+    unsigned int bulk_epochs[3];                           // last epoch a batch changed a whole type
+
+    void raise_ceiling(Money balance);
+    void mark_changed(size_t id, std::vector<size_t> &changed) {
+        unsigned int epoch = static_cast<unsigned int>(epoch_changes.size() - 1);
+        if (changed_epochs[id] != epoch) {
+            changed_epochs[id] = epoch;
+            changed.push_back(id);
+        }
+    }
+
+    // One-account transactions against a caller-owned ceiling and change list, so threads working
+    // on disjoint accounts never write the same member
+    Expected<Money> try_deposit(size_t id, Money amount, long long &ceiling, std::vector<size_t> &changed);
+    Expected<Money> try_withdraw(size_t id, Money amount, long long &ceiling, std::vector<size_t> &changed);
+public:
+    Account_Ledger();
+
+    void reserve(size_t count);
+    size_t add(Account_Type type, std::string name, Money balance = 0.0, double int_rate = 0.0);   // returns the new id
+
+    // One account - same results, return values and exceptions as the Account classes
+    Expected<Money> try_deposit(size_t id, Money amount);
+    Expected<Money> try_withdraw(size_t id, Money amount);
+    bool deposit(size_t id, Money amount);
+    void withdraw(size_t id, Money amount);
+
+    // Every account of one type - rejected transactions are counted instead of thrown
+    Batch_Result deposit_all(Account_Type type, Money amount);
+    Batch_Result withdraw_all(Account_Type type, Money amount);
+
+    // Compounds one period of interest on every savings and trust account, with the same result as
+    // Savings_Account::accrue_interest on each of them. The arrays are cut into fixed-size chunks that
+    // are split between threads (0 = one per core); per-chunk totals are added up in chunk order, so
+    // the result does not depend on the thread count.
+    Accrual_Report accrue_interest(int periods_per_year = 12, unsigned int threads = 0);
+
+    // Incremental statements
+    // Time is cut into numbered epochs, starting at 0. The first balance change of an account in an
+    // epoch appends its id to that epoch's list, so changes_since() walks only the lists of the epochs
+    // asked for - its cost follows the activity, not the size of the book. New accounts count as
+    // changed. A batch over a whole type (deposit_all, withdraw_all, accrue_interest) marks the type
+    // instead of each account, and reports every account of it, including ones the batch rejected.
+    // The usual cycle: changes = changes_since(last); last = begin_epoch();
+    unsigned int begin_epoch();                    // starts the next epoch and returns its number
+    unsigned int get_epoch() const;
+    std::vector<Balance_Change> changes_since(unsigned int epoch) const;    // sorted by id
+
+    size_t size() const;                          // getters
+    size_t count(Account_Type type) const;
+    size_t get_id(size_t idx) const;
+    Account_Type get_type(size_t id) const;
+    Money get_balance(size_t id) const;
+    double get_int_rate(size_t id) const;
+    int get_num_withdrawals(size_t id) const;
+    const std::string &get_name(size_t id) const;
+};
+
+#endif // _ACCOUNT_LEDGER_H_
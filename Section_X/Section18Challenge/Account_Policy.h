@@ -0,0 +1,83 @@
+#ifndef _ACCOUNT_POLICY_H_
+#define _ACCOUNT_POLICY_H_
+#include <limits>
+#include "Money.h"
+#include "Expected.h"
+
+// One account product's rules, as data
+// Checking_Account, Savings_Account and Trust_Account are three rows of this table; a new product
+// variant is a new row, not a new subclass.
+struct Account_Policy {
+    const char *product;
+    bool deposit_interest;         // deposits are increased by int_rate percent (savings and trust)
+    Money bonus_threshold;         // deposits of at least this much...
+    Money deposit_bonus;           // ...get this added first (0 = no bonus)
+    Money withdrawal_fee;          // added to every withdrawal
+    int max_withdrawals;           // 0 = no limit
+    int max_withdraw_percent;      // largest withdrawal as a percent of the balance, 0 = no cap
+};
+
+// An Account_Policy turned into the form the transactions need
+// The constructor resolves the "no bonus / no limit / no cap" cases into values that make the
+// checks come out false, so deposit() and withdraw() run the same short sequence for every
+// product. Everything is constexpr: a policy known at compile time (like Trust_Account::rules)
+// folds into constants and costs what the hand-written rules did; one compiled from a table at
+// run time reads a few fields from a single cache line. The account classes themselves, and
+// Account_Ledger, Account_Store and Concurrent_Account (through rules_for), all evaluate these rows,
+// so every engine applies the same rules with the same results, errors and exceptions
+// (MoneyOverflowException).
+class Compiled_Policy
+{
+    friend class Account_Ledger;      // vectorizes the same rules over its columns
+    friend class Concurrent_Account;  // bounds its packed 56-bit balance by the fee
+private:
+    const char *product;
+    double interest_on;            // 1 or 0, multiplies the account's int_rate
+    Money bonus_threshold;         // above every possible amount when there is no bonus
+    Money deposit_bonus;
+    Money withdrawal_fee;
+    int max_withdrawals;           // int's maximum when there is no limit
+    int max_withdraw_percent;
+    bool capped;
+    bool counted;                  // only products with a limit keep count
+public:
+    constexpr explicit Compiled_Policy(const Account_Policy &policy)
+        : product {policy.product},
+          interest_on {policy.deposit_interest ? 1.0 : 0.0},
+          bonus_threshold {policy.deposit_bonus != Money{} ? policy.bonus_threshold
+                                                           : Money::from_cents(std::numeric_limits<long long>::max())},
+          deposit_bonus {policy.deposit_bonus},
+          withdrawal_fee {policy.withdrawal_fee},
+          max_withdrawals {policy.max_withdrawals > 0 ? policy.max_withdrawals : std::numeric_limits<int>::max()},
+          max_withdraw_percent {policy.max_withdraw_percent},
+          capped {policy.max_withdraw_percent > 0},
+          counted {policy.max_withdrawals > 0} {
+    }
+
+    // The new balance, or negative_deposit
+    constexpr Expected<Money> deposit(Money balance, Money amount, double int_rate) const {
+        if (amount >= bonus_threshold)
+            amount += deposit_bonus;
+        amount += amount.scaled(int_rate * interest_on / 100);
+        if (amount < Money{})
+            return Account_Error::negative_deposit;
+        return balance + amount;
+    }
+
+    // The new balance, or illegal_trust_withdrawal / insufficient_funds. For a product with a
+    // withdrawal limit, withdrawals counts the ones that got past the limits, including ones the
+    // balance then rejects (as Trust_Account does)
+    constexpr Expected<Money> withdraw(Money balance, int &withdrawals, Money amount) const {
+        amount += withdrawal_fee;
+        if (withdrawals >= max_withdrawals || (capped && amount * 100 > balance * max_withdraw_percent))
+            return Account_Error::illegal_trust_withdrawal;
+        withdrawals += counted;
+        if (balance - amount >= Money{})
+            return balance - amount;
+        return Account_Error::insufficient_funds;
+    }
+
+    constexpr const char *get_product() const { return product; }
+};
+
+#endif // _ACCOUNT_POLICY_H_
@@ -0,0 +1,91 @@
+#include <new>
+#include "Account_Pool.h"
+
+void Slab_Pool::Slab_Deleter::operator()(unsigned char *slab) const {
+    ::operator delete(slab, std::align_val_t{alignment});
+}
+
+Slab_Pool::Slab_Pool(size_t slot_size, size_t alignment, size_t slots_per_slab)
+    : slot_size {(slot_size + alignment - 1) / alignment * alignment}, alignment {alignment},
+      slots_per_slab {slots_per_slab}, current_slab {0}, next_slot {nullptr}, slab_end {nullptr},
+      free_list {nullptr}, live {0} {
+        if (this->slot_size < sizeof(Free_Slot))
+            this->slot_size = sizeof(Free_Slot);
+}
+
+void Slab_Pool::add_slab() {
+    void *slab = ::operator new(slot_size * slots_per_slab, std::align_val_t{alignment});
+    std::unique_ptr<unsigned char[], Slab_Deleter> owned {static_cast<unsigned char *>(slab), Slab_Deleter{alignment}};
+    slabs.push_back(std::move(owned));
+}
+
+void Slab_Pool::next_slab() {
+    size_t bytes = slot_size * slots_per_slab;
+    if (next_slot != nullptr)
+        current_slab++;
+    if (current_slab == slabs.size())
+        add_slab();
+    next_slot = slabs[current_slab].get();
+    slab_end = next_slot + bytes;
+}
+
+// Every slot is either live, on the free list or not handed out yet
+void Slab_Pool::reserve(size_t count) {
+    while (get_capacity() - live < count)
+        add_slab();
+}
+
+size_t Slab_Pool::get_live() const { return live; }
+
+size_t Slab_Pool::get_capacity() const { return slabs.size() * slots_per_slab; }
+
+// dynamic_cast<void *> finds the start of the most derived object, which is where its slot begins
+void Pool_Deleter::operator()(Account *account) const {
+    void *slot = dynamic_cast<void *>(account);
+    account->~Account();
+    pool->deallocate(slot);
+}
+
+Account_Pools::Account_Pools(size_t slots_per_slab)
+    : checking {sizeof(Checking_Account), alignof(Checking_Account), slots_per_slab},
+      savings {sizeof(Savings_Account), alignof(Savings_Account), slots_per_slab},
+      trust {sizeof(Trust_Account), alignof(Trust_Account), slots_per_slab} {
+}
+
+// If the constructor throws, the slot goes straight back to the pool
+template <typename Type, typename... Args>
+Pooled_Account Account_Pools::construct(Slab_Pool &pool, Args &&...args) {
+    void *slot = pool.allocate();
+    try {
+        return Pooled_Account{new (slot) Type(std::forward<Args>(args)...), Pool_Deleter{&pool}};
+    }
+    catch (...) {
+        pool.deallocate(slot);
+        throw;
+    }
+}
+
+Expected<Pooled_Account> Account_Pools::make(Account_Type type, std::string name, Money balance, double int_rate) {
+    if (balance < Money{})
+        return Account_Error::illegal_balance;
+    switch (type) {
+        case Account_Type::checking: return construct<Checking_Account>(checking, std::move(name), balance);
+        case Account_Type::savings:  return construct<Savings_Account>(savings, std::move(name), balance, int_rate);
+        case Account_Type::trust:    break;
+    }
+    return construct<Trust_Account>(trust, std::move(name), balance, int_rate);
+}
+
+void Account_Pools::reserve(Account_Type type, size_t count) {
+    Slab_Pool &pool = type == Account_Type::checking ? checking : type == Account_Type::savings ? savings : trust;
+    pool.reserve(count);
+}
+
+size_t Account_Pools::get_live(Account_Type type) const {
+    switch (type) {
+        case Account_Type::checking: return checking.get_live();
+        case Account_Type::savings:  return savings.get_live();
+        case Account_Type::trust:    break;
+    }
+    return trust.get_live();
+}
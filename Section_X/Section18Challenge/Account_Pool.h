@@ -0,0 +1,99 @@
+#ifndef _ACCOUNT_POOL_H_
+#define _ACCOUNT_POOL_H_
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Account.h"
+#include "Checking_Account.h"
+#include "Savings_Account.h"
+#include "Trust_Account.h"
+#include "Account_Ledger.h"
+
+// Fixed-size slots carved out of large slabs
+// New slots are handed out back to back, so objects allocated one after the other sit next to each
+// other in memory and a pass in allocation order reads them sequentially. Freed slots go on a free
+// list and are reused first. One global allocation per slab instead of one per object.
+class Slab_Pool
+{
+private:
+    struct Free_Slot {
+        Free_Slot *next;
+    };
+    struct Slab_Deleter {
+        size_t alignment;
+        void operator()(unsigned char *slab) const;
+    };
+
+    size_t slot_size;
+    size_t alignment;
+    size_t slots_per_slab;
+    std::vector<std::unique_ptr<unsigned char[], Slab_Deleter>> slabs;
+    size_t current_slab;                 // the slab next_slot bumps through
+    unsigned char *next_slot;
+    unsigned char *slab_end;
+    Free_Slot *free_list;
+    size_t live;
+
+    void add_slab();
+    void next_slab();                    // moves on to the next slab, allocating it if needed
+public:
+    Slab_Pool(size_t slot_size, size_t alignment, size_t slots_per_slab = 4096);
+    Slab_Pool(const Slab_Pool &) = delete;
+    Slab_Pool &operator=(const Slab_Pool &) = delete;
+
+    void *allocate() {
+        live++;
+        if (free_list) {
+            void *slot = free_list;
+            free_list = free_list->next;
+            return slot;
+        }
+        if (next_slot == slab_end)
+            next_slab();
+        void *slot = next_slot;
+        next_slot += slot_size;
+        return slot;
+    }
+    void deallocate(void *slot) {
+        live--;
+        free_list = new (slot) Free_Slot{free_list};
+    }
+    void reserve(size_t count);          // slabs for count more slots
+
+    size_t get_live() const;              // slots handed out and not yet returned
+    size_t get_capacity() const;          // slots in all slabs
+};
+
+// Destroys a pooled account and gives its slot back to the pool it came from
+struct Pool_Deleter {
+    Slab_Pool *pool;
+    void operator()(Account *account) const;
+};
+
+using Pooled_Account = std::unique_ptr<Account, Pool_Deleter>;
+
+// One slab pool per concrete account type, and a factory that fills them
+// make() follows make_account(): an illegal balance comes back as an error instead of a throw. The
+// returned pointers work like std::unique_ptr<Account> but must not outlive the Account_Pools.
+class Account_Pools
+{
+private:
+    Slab_Pool checking;
+    Slab_Pool savings;
+    Slab_Pool trust;
+
+    template <typename Type, typename... Args>
+    static Pooled_Account construct(Slab_Pool &pool, Args &&...args);
+public:
+    explicit Account_Pools(size_t slots_per_slab = 4096);
+    Account_Pools(const Account_Pools &) = delete;
+    Account_Pools &operator=(const Account_Pools &) = delete;
+
+    Expected<Pooled_Account> make(Account_Type type, std::string name, Money balance = 0.0, double int_rate = 0.0);
+    void reserve(Account_Type type, size_t count);      // slabs for count more accounts of that type
+
+    size_t get_live(Account_Type type) const;
+};
+
+#endif // _ACCOUNT_POOL_H_
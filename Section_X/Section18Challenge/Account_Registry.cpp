@@ -0,0 +1,136 @@
+#include <functional>
+#include "Account_Registry.h"
+
+Account_Registry::Account_Registry()
+    : slots(16, Slot{0, empty}), count {0} {
+}
+
+uint64_t Account_Registry::hash_of(std::string_view name) {
+    return std::hash<std::string_view>{}(name);
+}
+
+const std::string &Account_Registry::name_of(size_t id) const {
+    return as_account(get(id)).name;
+}
+
+size_t Account_Registry::find_slot(std::string_view name, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].id != empty && (slots[i].hash != hash || name_of(slots[i].id) != name))
+        i = (i + 1) & mask;
+    return i;
+}
+
+// Moves every entry to a table of slot_count slots, reusing the stored hashes
+void Account_Registry::rehash(size_t slot_count) {
+    std::vector<Slot> old(slot_count, Slot{0, empty});
+    old.swap(slots);
+    size_t mask = slot_count - 1;
+    for (const Slot &slot : old) {
+        if (slot.id == empty)
+            continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].id != empty)
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+Expected<size_t> Account_Registry::add(Account_Type type, std::string name, Money balance, double int_rate) {
+    if (balance < Money{})
+        return Account_Error::illegal_balance;
+    uint64_t hash = hash_of(name);
+    size_t slot = find_slot(name, hash);
+    if (slots[slot].id != empty)
+        return Account_Error::duplicate_name;
+
+    if ((count & (chunk_size - 1)) == 0 && count >> chunk_bits == chunks.size()) {
+        chunks.emplace_back();
+        chunks.back().reserve(chunk_size);
+    }
+    std::vector<Account_Variant> &chunk = chunks[count >> chunk_bits];
+    switch (type) {
+        case Account_Type::checking:
+            chunk.emplace_back(std::in_place_type<Checking_Account>, std::move(name), balance);
+            break;
+        case Account_Type::savings:
+            chunk.emplace_back(std::in_place_type<Savings_Account>, std::move(name), balance, int_rate);
+            break;
+        case Account_Type::trust:
+            chunk.emplace_back(std::in_place_type<Trust_Account>, std::move(name), balance, int_rate);
+            break;
+    }
+    slots[slot] = Slot{hash, count};
+    count++;
+    if (count * 2 > slots.size())
+        rehash(slots.size() * 2);
+    return count - 1;
+}
+
+void Account_Registry::reserve(size_t account_count) {
+    size_t slot_count = slots.size();
+    while (slot_count < account_count * 2)
+        slot_count *= 2;
+    if (slot_count != slots.size())
+        rehash(slot_count);
+    chunks.reserve((account_count + chunk_size - 1) >> chunk_bits);
+}
+
+Expected<size_t> Account_Registry::find(std::string_view name) const {
+    size_t id = slots[find_slot(name, hash_of(name))].id;
+    if (id == empty)
+        return Account_Error::unknown_account;
+    return id;
+}
+
+bool Account_Registry::contains(std::string_view name) const {
+    return slots[find_slot(name, hash_of(name))].id != empty;
+}
+
+Expected<Money> Account_Registry::try_deposit(size_t id, Money amount) {
+    if (id >= count)
+        return Account_Error::unknown_account;
+    return ::try_deposit(get(id), amount);
+}
+
+Expected<Money> Account_Registry::try_withdraw(size_t id, Money amount) {
+    if (id >= count)
+        return Account_Error::unknown_account;
+    return ::try_withdraw(get(id), amount);
+}
+
+Expected<Money> Account_Registry::try_deposit(std::string_view name, Money amount) {
+    size_t id = slots[find_slot(name, hash_of(name))].id;
+    if (id == empty)
+        return Account_Error::unknown_account;
+    return ::try_deposit(get(id), amount);
+}
+
+Expected<Money> Account_Registry::try_withdraw(std::string_view name, Money amount) {
+    size_t id = slots[find_slot(name, hash_of(name))].id;
+    if (id == empty)
+        return Account_Error::unknown_account;
+    return ::try_withdraw(get(id), amount);
+}
+
+size_t Account_Registry::add_account(Account_Type type, std::string name, Money balance, double int_rate) {
+    Expected<size_t> id = add(type, std::move(name), balance, int_rate);
+    if (!id)
+        throw_account_error(id.error());
+    return id.value();
+}
+
+bool Account_Registry::deposit(std::string_view name, Money amount) {
+    Expected<Money> result = try_deposit(name, amount);
+    if (!result && result.error() == Account_Error::unknown_account)
+        throw_account_error(result.error());
+    return result.has_value();
+}
+
+void Account_Registry::withdraw(std::string_view name, Money amount) {
+    Expected<Money> result = try_withdraw(name, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+size_t Account_Registry::size() const { return count; }
@@ -0,0 +1,66 @@
+#ifndef _ACCOUNT_REGISTRY_H_
+#define _ACCOUNT_REGISTRY_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Account_Util.h"
+
+// Owner and index of a book of accounts, by name and by dense id
+// Accounts are stored by value in fixed-size chunks that are never reallocated, so the id handed out
+// by add() - and any reference to the account - stays valid however far the registry grows. Names are
+// indexed by an open-addressing hash table (linear probing, kept at most half full) that stores each
+// name's hash next to its id, so a lookup touches one or two slots and compares a single name.
+// Accounts are never removed; ids run from 0 to size() - 1.
+class Account_Registry
+{
+private:
+    static constexpr size_t chunk_bits = 12;
+    static constexpr size_t chunk_size = size_t{1} << chunk_bits;     // accounts per chunk
+    static constexpr size_t empty = static_cast<size_t>(-1);
+
+    struct Slot {
+        uint64_t hash;
+        size_t id;                  // empty for an unused slot
+    };
+
+    std::vector<std::vector<Account_Variant>> chunks;    // each reserved to chunk_size up front
+    std::vector<Slot> slots;                              // size is a power of 2
+    size_t count;
+
+    static uint64_t hash_of(std::string_view name);
+    const std::string &name_of(size_t id) const;
+    size_t find_slot(std::string_view name, uint64_t hash) const;   // the name's slot, or the empty one it would take
+    void rehash(size_t slot_count);
+public:
+    Account_Registry();
+
+    // Returns the new account's id - or illegal_balance, or duplicate_name if the name is taken
+    Expected<size_t> add(Account_Type type, std::string name, Money balance = 0.0, double int_rate = 0.0);
+    void reserve(size_t account_count);
+
+    Expected<size_t> find(std::string_view name) const;     // unknown_account if there is none
+    bool contains(std::string_view name) const;
+
+    // Only valid for id < size()
+    Account_Variant &get(size_t id) { return chunks[id >> chunk_bits][id & (chunk_size - 1)]; }
+    const Account_Variant &get(size_t id) const { return chunks[id >> chunk_bits][id & (chunk_size - 1)]; }
+
+    // Transactions routed by id or by name; an unknown one comes back as unknown_account
+    Expected<Money> try_deposit(size_t id, Money amount);
+    Expected<Money> try_withdraw(size_t id, Money amount);
+    Expected<Money> try_deposit(std::string_view name, Money amount);
+    Expected<Money> try_withdraw(std::string_view name, Money amount);
+
+    // Throwing versions: add_account throws IllegalBalanceException or DuplicateAccountException, and
+    // deposit / withdraw throw UnknownAccountException for a name that isn't registered, otherwise
+    // behaving like Account::deposit and Account::withdraw
+    size_t add_account(Account_Type type, std::string name, Money balance = 0.0, double int_rate = 0.0);
+    bool deposit(std::string_view name, Money amount);
+    void withdraw(std::string_view name, Money amount);
+
+    size_t size() const;
+};
+
+#endif // _ACCOUNT_REGISTRY_H_
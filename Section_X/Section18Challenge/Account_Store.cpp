@@ -0,0 +1,208 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Account_Store.h"
+
+// On-disk layout, fixed-width fields only, in host byte order: a book is not portable between
+// machines of different endianness
+struct Account_Store::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint64_t count;
+    uint64_t record_capacity;
+    uint64_t heap_size;
+    uint64_t heap_capacity;
+    uint64_t reserved[2];
+};
+
+struct Account_Store::Record {
+    int64_t cents;
+    double int_rate;
+    uint64_t name_offset;            // into the heap
+    uint32_t name_length;
+    uint8_t type;                    // Account_Type
+    uint8_t num_withdrawals;         // trust accounts only
+    uint16_t reserved;
+};
+
+static constexpr uint32_t store_magic = 0x52545341;           // "ASTR"
+static constexpr uint32_t store_version = 1;
+
+size_t Account_Store::file_size(size_t record_capacity, size_t heap_capacity) {
+    return sizeof(Header) + record_capacity * sizeof(Record) + heap_capacity;
+}
+
+// Opens the book at path, creating an empty one if the file does not exist. The destructor does not
+// run when this throws, so every failure after the open unmaps and closes here
+Account_Store::Account_Store(std::string path, size_t record_capacity, size_t heap_capacity)
+    : path {path}, fd {-1}, base {nullptr}, mapped_size {0}, header {nullptr}, records {nullptr}, heap {nullptr} {
+        static_assert(sizeof(Header) == 64 && sizeof(Record) == 32, "the file layout must not depend on the compiler");
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            throw StoreIOException();
+        try {
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+                throw StoreIOException();
+            size_t size = static_cast<size_t>(info.st_size);
+            if (size == 0) {
+                record_capacity = record_capacity > 0 ? record_capacity : 1;
+                heap_capacity = heap_capacity > 0 ? heap_capacity : 1;
+                size = file_size(record_capacity, heap_capacity);
+                if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+                    throw StoreIOException();
+                map(size);
+                *header = Header{store_magic, store_version, sizeof(Header), sizeof(Record), 0, record_capacity, 0,
+                                 heap_capacity, {0, 0}};
+                records = reinterpret_cast<Record *>(base + sizeof(Header));
+                heap = base + sizeof(Header) + record_capacity * sizeof(Record);
+                return;
+            }
+            if (size < sizeof(Header))
+                throw StoreIOException();
+            map(size);
+            // Zero capacities would never double; capacities beyond the file size would overflow file_size
+            if (header->magic != store_magic || header->version != store_version
+                    || header->header_size != sizeof(Header) || header->record_size != sizeof(Record)
+                    || header->record_capacity == 0 || header->heap_capacity == 0
+                    || header->record_capacity > size / sizeof(Record) || header->heap_capacity > size
+                    || header->count > header->record_capacity || header->heap_size > header->heap_capacity
+                    || file_size(header->record_capacity, header->heap_capacity) > size)
+                throw StoreIOException();
+        }
+        catch (...) {
+            unmap();
+            ::close(fd);
+            throw;
+        }
+}
+
+Account_Store::~Account_Store() {
+    unmap();
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void Account_Store::map(size_t size) {
+    void *address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+        throw StoreIOException();
+    base = static_cast<char *>(address);
+    mapped_size = size;
+    header = reinterpret_cast<Header *>(base);
+    if (header->header_size == sizeof(Header)) {
+        records = reinterpret_cast<Record *>(base + sizeof(Header));
+        heap = base + sizeof(Header) + header->record_capacity * sizeof(Record);
+    }
+}
+
+void Account_Store::unmap() {
+    if (base != nullptr)
+        ::munmap(base, mapped_size);
+    base = nullptr;
+    header = nullptr;
+    records = nullptr;
+    heap = nullptr;
+}
+
+// Doubles whichever section is full, then slides the heap up past the new record space. The new size
+// is mapped before the old mapping is dropped, so if the file cannot be extended or mapped the store
+// is exactly as it was (a file longer than the header says is harmless)
+void Account_Store::grow(size_t records_needed, size_t heap_needed) {
+    size_t record_capacity = header->record_capacity;
+    size_t heap_capacity = header->heap_capacity;
+    size_t heap_size = header->heap_size;
+    size_t old_heap_offset = sizeof(Header) + record_capacity * sizeof(Record);
+    while (record_capacity < records_needed)
+        record_capacity *= 2;
+    while (heap_capacity < heap_needed)
+        heap_capacity *= 2;
+    size_t size = file_size(record_capacity, heap_capacity);
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        throw StoreIOException();
+    char *old_base = base;
+    size_t old_size = mapped_size;
+    map(size);                                  // only replaces base and the pointers once it has succeeded
+    ::munmap(old_base, old_size);
+    size_t new_heap_offset = sizeof(Header) + record_capacity * sizeof(Record);
+    std::memmove(base + new_heap_offset, base + old_heap_offset, heap_size);
+    header->record_capacity = record_capacity;
+    header->heap_capacity = heap_capacity;
+    heap = base + new_heap_offset;
+}
+
+size_t Account_Store::add(Account_Type type, std::string_view name, Money balance, double int_rate) {
+    if (balance < Money{})
+        throw IllegalBalanceException();
+    if (header->count == header->record_capacity || header->heap_size + name.size() > header->heap_capacity)
+        grow(header->count + 1, header->heap_size + name.size());
+    size_t id = header->count;
+    Record &record = records[id];
+    record.cents = balance.get_cents();
+    record.int_rate = type == Account_Type::checking ? 0.0 : int_rate;
+    record.name_offset = header->heap_size;
+    record.name_length = static_cast<uint32_t>(name.size());
+    record.type = static_cast<uint8_t>(type);
+    record.num_withdrawals = 0;
+    record.reserved = 0;
+    std::memcpy(heap + header->heap_size, name.data(), name.size());
+    header->heap_size += name.size();
+    header->count++;
+    return id;
+}
+
+// Same rules as Account_Ledger::try_deposit, applied to the record in place
+Expected<Money> Account_Store::try_deposit(size_t id, Money amount) {
+    Record &record = records[id];
+    const Compiled_Policy &rules = rules_for(static_cast<Account_Type>(record.type));
+    Expected<Money> result = rules.deposit(Money::from_cents(record.cents), amount, record.int_rate);
+    if (result)
+        record.cents = result.value().get_cents();
+    return result;
+}
+
+// Same rules as Account_Ledger::try_withdraw, applied to the record in place
+Expected<Money> Account_Store::try_withdraw(size_t id, Money amount) {
+    Record &record = records[id];
+    const Compiled_Policy &rules = rules_for(static_cast<Account_Type>(record.type));
+    int withdrawals {record.num_withdrawals};
+    Expected<Money> result = rules.withdraw(Money::from_cents(record.cents), withdrawals, amount);
+    record.num_withdrawals = static_cast<uint8_t>(withdrawals);
+    if (result)
+        record.cents = result.value().get_cents();
+    return result;
+}
+
+bool Account_Store::deposit(size_t id, Money amount) {
+    return try_deposit(id, amount).has_value();
+}
+
+void Account_Store::withdraw(size_t id, Money amount) {
+    Expected<Money> result = try_withdraw(id, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+void Account_Store::flush() {
+    if (::msync(base, mapped_size, MS_SYNC) != 0)
+        throw StoreIOException();
+}
+
+// getters
+size_t Account_Store::size() const { return header->count; }
+Account_Type Account_Store::get_type(size_t id) const { return static_cast<Account_Type>(records[id].type); }
+Money Account_Store::get_balance(size_t id) const { return Money::from_cents(records[id].cents); }
+double Account_Store::get_int_rate(size_t id) const { return records[id].int_rate; }
+int Account_Store::get_num_withdrawals(size_t id) const { return records[id].num_withdrawals; }
+std::string_view Account_Store::get_name(size_t id) const {
+    const Record &record = records[id];
+    if (record.name_offset > header->heap_size || record.name_length > header->heap_size - record.name_offset)
+        throw StoreIOException();
+    return std::string_view{heap + record.name_offset, record.name_length};
+}
@@ -0,0 +1,62 @@
+#ifndef _ACCOUNT_STORE_H_
+#define _ACCOUNT_STORE_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Account_Ledger.h"
+#include "StoreIOException.h"
+
+// Memory-mapped account book
+// The file is the data structure: a 64-byte header (magic, version, sizes), then one fixed 32-byte
+// record per account (balance in cents, rate, type, trust withdrawals, where the name is), then a heap
+// holding the names back to back. Opening maps the file and checks the header - nothing is parsed or
+// constructed, so a book of any size opens in about the same time, and only the pages a query touches
+// are read from disk. Transactions update the record in place with the same rules as the Account
+// classes; the kernel writes dirty pages back, and flush() forces them to disk.
+//
+// When the records or the heap run out of room the file is doubled and remapped (the heap moves up),
+// which also invalidates any name views handed out before.
+class Account_Store
+{
+private:
+    struct Header;
+    struct Record;
+
+    std::string path;
+    int fd;
+    char *base;
+    size_t mapped_size;
+    Header *header;
+    Record *records;
+    char *heap;
+
+    static size_t file_size(size_t record_capacity, size_t heap_capacity);
+    void map(size_t size);
+    void unmap();
+    void grow(size_t records_needed, size_t heap_needed);
+public:
+    explicit Account_Store(std::string path, size_t record_capacity = 1024, size_t heap_capacity = 16 * 1024);
+    Account_Store(const Account_Store &) = delete;
+    Account_Store &operator=(const Account_Store &) = delete;
+    ~Account_Store();
+
+    size_t add(Account_Type type, std::string_view name, Money balance = 0.0, double int_rate = 0.0);
+
+    // Same results, return values and exceptions as the Account classes
+    Expected<Money> try_deposit(size_t id, Money amount);
+    Expected<Money> try_withdraw(size_t id, Money amount);
+    bool deposit(size_t id, Money amount);
+    void withdraw(size_t id, Money amount);
+
+    void flush();                                    // msync: everything so far is on disk
+
+    size_t size() const;                             // getters
+    Account_Type get_type(size_t id) const;
+    Money get_balance(size_t id) const;
+    double get_int_rate(size_t id) const;
+    int get_num_withdrawals(size_t id) const;
+    std::string_view get_name(size_t id) const;      // points into the mapping; StoreIOException if it points outside the heap
+};
+
+#endif // _ACCOUNT_STORE_H_
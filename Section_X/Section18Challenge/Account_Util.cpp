@@ -0,0 +1,190 @@
+#include <iostream>
+#include "Account_Util.h"
+#include <type_traits>
+#include "IllegalTrustWithdrawalException.h"
+
+// Displays Account objects in a vector of pointers to Account objects 
+void display(const std::vector<Account *> &accounts) {
+    display(std::cout, accounts);
+}
+
+// The same text as printing each account with operator<< and std::endl, but formatted into one
+// buffer and written out a batch at a time, with a single flush at the end
+void display(std::ostream &os, const std::vector<Account *> &accounts) {
+    Print_Buffer buffer {Print_Buffer::batch_size + 4096};
+    buffer.append("\n=== Accounts===========================================\n");
+    for (const auto &acc: accounts) {
+        acc->format(buffer);
+        buffer.append('\n');
+        if (buffer.size() >= Print_Buffer::batch_size)
+            buffer.write_to(os);
+    }
+    buffer.write_to(os);
+    if (!accounts.empty()) {
+        os.precision(2);
+        os << std::fixed;
+    }
+    os.flush();
+}
+
+// Deposits supplied amount to each Account object in the vector
+void deposit(std::vector<Account *> &accounts, Money amount) {
+    std::cout << "\n=== Depositing to Accounts =================================" << std::endl;
+    for (auto &acc:accounts)  {
+        if (acc->deposit(amount)) 
+            std::cout << "Deposited " << amount << " to " << *acc << std::endl;
+        else
+            std::cout << "Failed Deposit of " << amount << " to " << *acc << std::endl;
+    }
+}
+
+// Withdraw amount from each Account object in the vector
+void withdraw(std::vector<Account *> &accounts, Money amount) {
+    std::cout << "\n=== Withdrawing from Accounts ==============================" <<std::endl;
+    for (auto &acc:accounts)  {
+        try {
+            acc->withdraw(amount);
+            std::cout << "Withdrew " << amount << " from " << *acc << std::endl;
+        }
+        catch (const InsufficientFundsException &ex) {
+            std::cout << "Failed Withdrawal of " << amount << " from " << *acc << " - " << ex.what() << std::endl;
+        }
+        catch (const IllegalTrustWithdrawalException &ex) {
+            std::cout << "Failed Withdrawal of " << amount << " from " << *acc << " - " << ex.what() << std::endl;
+        }
+    } 
+}
+
+Expected<std::unique_ptr<Account>> make_account(Account_Type type, std::string name, Money balance, double int_rate) {
+    if (balance < Money{})
+        return Account_Error::illegal_balance;
+    switch (type) {
+        case Account_Type::checking: return std::unique_ptr<Account>{std::make_unique<Checking_Account>(name, balance)};
+        case Account_Type::savings:  return std::unique_ptr<Account>{std::make_unique<Savings_Account>(name, balance, int_rate)};
+        case Account_Type::trust:    break;
+    }
+    return std::unique_ptr<Account>{std::make_unique<Trust_Account>(name, balance, int_rate)};
+}
+
+// Variant accounts
+
+Account &as_account(Account_Variant &account) {
+    return std::visit([](auto &acc) -> Account & { return acc; }, account);
+}
+
+const Account &as_account(const Account_Variant &account) {
+    return std::visit([](const auto &acc) -> const Account & { return acc; }, account);
+}
+
+Expected<Money> try_deposit(Account_Variant &account, Money amount) {
+    return std::visit([amount](auto &acc) {
+        using Type = std::decay_t<decltype(acc)>;
+        return acc.Type::try_deposit(amount);
+    }, account);
+}
+
+Expected<Money> try_withdraw(Account_Variant &account, Money amount) {
+    return std::visit([amount](auto &acc) {
+        using Type = std::decay_t<decltype(acc)>;
+        return acc.Type::try_withdraw(amount);
+    }, account);
+}
+
+bool deposit(Account_Variant &account, Money amount) {
+    return try_deposit(account, amount).has_value();
+}
+
+void withdraw(Account_Variant &account, Money amount) {
+    Expected<Money> result = try_withdraw(account, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+static void format(Print_Buffer &buffer, const Account_Variant &account) {
+    std::visit([&buffer](const auto &acc) {
+        using Type = std::decay_t<decltype(acc)>;
+        acc.Type::format(buffer);
+    }, account);
+}
+
+// What I_Printable::print does, but through the qualified format() above instead of a virtual call
+static void print(std::ostream &os, const Account_Variant &account) {
+    thread_local Print_Buffer buffer;
+    os.precision(2);
+    os << std::fixed;
+    buffer.clear();
+    format(buffer, account);
+    buffer.write_to(os);
+}
+
+// Displays the accounts in a vector of account variants
+void display(const std::vector<Account_Variant> &accounts) {
+    display(std::cout, accounts);
+}
+
+void display(std::ostream &os, const std::vector<Account_Variant> &accounts) {
+    Print_Buffer buffer {Print_Buffer::batch_size + 4096};
+    buffer.append("\n=== Accounts===========================================\n");
+    for (const auto &acc: accounts) {
+        format(buffer, acc);
+        buffer.append('\n');
+        if (buffer.size() >= Print_Buffer::batch_size)
+            buffer.write_to(os);
+    }
+    buffer.write_to(os);
+    if (!accounts.empty()) {
+        os.precision(2);
+        os << std::fixed;
+    }
+    os.flush();
+}
+
+// Deposits supplied amount to each account in the vector
+void deposit(std::vector<Account_Variant> &accounts, Money amount) {
+    std::cout << "\n=== Depositing to Accounts =================================" << std::endl;
+    for (auto &acc:accounts)  {
+        if (deposit(acc, amount))
+            std::cout << "Deposited " << amount << " to ";
+        else
+            std::cout << "Failed Deposit of " << amount << " to ";
+        print(std::cout, acc);
+        std::cout << std::endl;
+    }
+}
+
+// Withdraw amount from each account in the vector
+void withdraw(std::vector<Account_Variant> &accounts, Money amount) {
+    std::cout << "\n=== Withdrawing from Accounts ==============================" <<std::endl;
+    for (auto &acc:accounts)  {
+        try {
+            withdraw(acc, amount);
+            std::cout << "Withdrew " << amount << " from ";
+            print(std::cout, acc);
+            std::cout << std::endl;
+        }
+        catch (const InsufficientFundsException &ex) {
+            std::cout << "Failed Withdrawal of " << amount << " from ";
+            print(std::cout, acc);
+            std::cout << " - " << ex.what() << std::endl;
+        }
+        catch (const IllegalTrustWithdrawalException &ex) {
+            std::cout << "Failed Withdrawal of " << amount << " from ";
+            print(std::cout, acc);
+            std::cout << " - " << ex.what() << std::endl;
+        }
+    }
+}
+
+Batch_Result deposit_all(std::vector<Account_Variant> &accounts, Money amount) {
+    size_t succeeded {0};
+    for (auto &acc:accounts)
+        succeeded += deposit(acc, amount);
+    return Batch_Result{succeeded, accounts.size() - succeeded};
+}
+
+Batch_Result withdraw_all(std::vector<Account_Variant> &accounts, Money amount) {
+    size_t succeeded {0};
+    for (auto &acc:accounts)
+        succeeded += try_withdraw(acc, amount).has_value();
+    return Batch_Result{succeeded, accounts.size() - succeeded};
+}
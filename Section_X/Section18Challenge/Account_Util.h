@@ -0,0 +1,48 @@
+#ifndef _ACCOUNT_UTIL_H_
+#define _ACCOUNT_UTIL_H_
+#include <memory>
+#include <variant>
+#include <vector>
+#include "Account.h"
+#include "Checking_Account.h"
+#include "Savings_Account.h"
+#include "Trust_Account.h"
+#include "Account_Ledger.h"
+
+// Utility helper functions for Account class
+
+void display(const std::vector<Account *> &accounts);
+void display(std::ostream &os, const std::vector<Account *> &accounts);     // buffered, one flush
+void deposit(std::vector<Account *> &accounts, Money amount);
+void withdraw(std::vector<Account *> &accounts, Money amount);
+
+// Creates an account without throwing - an illegal balance comes back as Account_Error::illegal_balance
+Expected<std::unique_ptr<Account>> make_account(Account_Type type, std::string name, Money balance = 0.0,
+                                                double int_rate = 0.0);
+
+// Closed set of account types, stored by value
+// std::visit picks the alternative with one switch on the variant's index, and the visitors call the
+// member functions qualified (acc.Trust_Account::deposit), so there is no vtable lookup and the
+// compiler can inline the whole transaction into the loop. Accounts sit contiguously in the vector
+// instead of one heap object per pointer.
+using Account_Variant = std::variant<Checking_Account, Savings_Account, Trust_Account>;
+
+Account &as_account(Account_Variant &account);              // for the non-virtual getters
+const Account &as_account(const Account_Variant &account);
+
+Expected<Money> try_deposit(Account_Variant &account, Money amount);
+Expected<Money> try_withdraw(Account_Variant &account, Money amount);
+bool deposit(Account_Variant &account, Money amount);
+void withdraw(Account_Variant &account, Money amount);       // throws like Account::withdraw
+
+void display(const std::vector<Account_Variant> &accounts);
+void display(std::ostream &os, const std::vector<Account_Variant> &accounts);
+void deposit(std::vector<Account_Variant> &accounts, Money amount);
+void withdraw(std::vector<Account_Variant> &accounts, Money amount);
+
+// Silent batch versions for hot loops - rejected transactions are counted, not printed
+Batch_Result deposit_all(std::vector<Account_Variant> &accounts, Money amount);
+Batch_Result withdraw_all(std::vector<Account_Variant> &accounts, Money amount);
+
+
+#endif
@@ -0,0 +1,1318 @@
+// Section 18
+// Account benchmarks
+//
+// Build from this folder with:
+//      g++ -std=c++17 -O3 -Wall -pthread -I.. main.cpp $(ls ../*.cpp | grep -v main.cpp) -o main
+// Add -march=native to let the compiler use AVX2 for the ledger loops, and -flto to let the variant
+// visitors inline the account member functions across files
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+#include "Account.h"
+#include "Checking_Account.h"
+#include "Savings_Account.h"
+#include "Trust_Account.h"
+#include "Account_Ledger.h"
+#include "Concurrent_Account.h"
+#include "Account_Util.h"
+#include "Account_Journal.h"
+#include "Account_Store.h"
+#include "Transaction_Processor.h"
+#include "Account_Registry.h"
+#include "Account_Pool.h"
+#include "Policy_Account.h"
+#include "Transfer_Engine.h"
+
+using namespace std;
+
+static double ms_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// The same book of accounts, once as heap objects and once as an Account_Ledger
+struct Book {
+    vector<unique_ptr<Account>> objects;
+    vector<Account *> by_type[3];          // what Account_Util callers hold today
+    Account_Ledger ledger;
+};
+
+static Book make_book(size_t count) {
+    Book book;
+    book.objects.reserve(count);
+    book.ledger.reserve(count);
+    mt19937_64 rng {2023};
+    uniform_real_distribution<double> balance_dist {0.0, 20000.0};
+    uniform_real_distribution<double> rate_dist {0.0, 5.0};
+    for (size_t i = 0; i < count; i++) {
+        Account_Type type = static_cast<Account_Type>(rng() % 3);
+        string name = "Account " + to_string(i);
+        double balance = balance_dist(rng);
+        double rate = rate_dist(rng);
+        if (type == Account_Type::checking)
+            book.objects.push_back(make_unique<Checking_Account>(name, balance));
+        else if (type == Account_Type::savings)
+            book.objects.push_back(make_unique<Savings_Account>(name, balance, rate));
+        else
+            book.objects.push_back(make_unique<Trust_Account>(name, balance, rate));
+        book.by_type[static_cast<int>(type)].push_back(book.objects.back().get());
+        book.ledger.add(type, name, balance, rate);
+    }
+    return book;
+}
+
+// One batch step applied both ways: a loop of virtual calls (catching rejected withdrawals) vs one ledger pass
+static void step(Book &book, const char *label, Account_Type type, bool is_deposit, double amount,
+                 double &object_ms, double &ledger_ms) {
+    size_t object_ok {0};
+    auto start = chrono::steady_clock::now();
+    for (Account *acc : book.by_type[static_cast<int>(type)]) {
+        if (is_deposit) {
+            object_ok += acc->deposit(amount);
+        } else {
+            try {
+                acc->withdraw(amount);
+                object_ok++;
+            }
+            catch (const exception &) {
+            }
+        }
+    }
+    double o_ms = ms_since(start);
+
+    start = chrono::steady_clock::now();
+    Batch_Result result = is_deposit ? book.ledger.deposit_all(type, amount) : book.ledger.withdraw_all(type, amount);
+    double l_ms = ms_since(start);
+
+    object_ms += o_ms;
+    ledger_ms += l_ms;
+    cout << setw(30) << left << label << right << fixed << setprecision(2)
+         << setw(10) << o_ms << " ms" << setw(10) << l_ms << " ms"
+         << setw(12) << result.succeeded << " ok" << setw(10) << result.failed << " rejected"
+         << (result.succeeded == object_ok ? "" : "   ** COUNT MISMATCH **") << endl;
+}
+
+static void bench_ledger(size_t count) {
+    Book book = make_book(count);
+    double object_ms {0};
+    double ledger_ms {0};
+    cout << setw(30) << left << "" << right << setw(13) << "objects" << setw(13) << "ledger" << endl;
+    step(book, "deposit 1000 to savings", Account_Type::savings, true, 1000, object_ms, ledger_ms);
+    step(book, "deposit 6000 to trust", Account_Type::trust, true, 6000, object_ms, ledger_ms);
+    step(book, "deposit 250 to checking", Account_Type::checking, true, 250, object_ms, ledger_ms);
+    step(book, "withdraw 5000 from checking", Account_Type::checking, false, 5000, object_ms, ledger_ms);
+    step(book, "withdraw 8000 from savings", Account_Type::savings, false, 8000, object_ms, ledger_ms);
+    for (int i = 0; i < 4; i++)
+        step(book, "withdraw 1500 from trust", Account_Type::trust, false, 1500, object_ms, ledger_ms);
+
+    size_t mismatches {0};
+    for (size_t id = 0; id < count; id++)
+        mismatches += (book.objects[id]->get_balance() != book.ledger.get_balance(id));
+    cout << "total: objects " << object_ms << " ms, ledger " << ledger_ms << " ms ("
+         << setprecision(1) << object_ms / ledger_ms << "x); "
+         << mismatches << " balances differ" << endl;
+}
+
+// One month of interest: a virtual-free loop over the savings and trust objects vs the ledger kernel
+// at several thread counts (each on its own copy of the ledger, so every run starts from the same balances)
+static void bench_accrual(size_t count) {
+    Book book = make_book(count);
+    Money object_interest;
+    auto start = chrono::steady_clock::now();
+    for (int t : {static_cast<int>(Account_Type::savings), static_cast<int>(Account_Type::trust)})
+        for (Account *acc : book.by_type[t])
+            object_interest += static_cast<Savings_Account *>(acc)->accrue_interest(12);
+    double o_ms = ms_since(start);
+    cout << setw(12) << left << "objects" << right << fixed << setprecision(2) << setw(10) << o_ms << " ms"
+         << setw(19) << object_interest << " interest" << endl;
+
+    vector<unsigned int> thread_counts {1, 2, 4};
+    unsigned int cores = thread::hardware_concurrency();
+    if (cores > 4)
+        thread_counts.push_back(cores);
+    for (unsigned int threads : thread_counts) {
+        Account_Ledger ledger = book.ledger;
+        Accrual_Report report = ledger.accrue_interest(12, threads);
+        size_t mismatches {0};
+        for (size_t id = 0; id < count; id++)
+            mismatches += (book.objects[id]->get_balance() != ledger.get_balance(id));
+        cout << setw(12) << left << ("ledger x" + to_string(report.threads)) << right
+             << setw(10) << report.seconds * 1000.0 << " ms"
+             << setw(19) << report.interest << " interest" << setw(8) << setprecision(0) << report.accounts_per_second / 1e6
+             << setprecision(2) << " M accounts/s, " << mismatches << " balances differ"
+             << (report.interest == object_interest ? "" : "   ** TOTAL MISMATCH **") << endl;
+    }
+}
+
+// The obvious way to share an account between threads: one mutex around the existing object
+class Locked_Account {
+private:
+    std::mutex mtx;
+    unique_ptr<Account> account;
+public:
+    explicit Locked_Account(unique_ptr<Account> account) : account {std::move(account)} {}
+    bool deposit(double amount) {
+        lock_guard<std::mutex> lock {mtx};
+        return account->deposit(amount);
+    }
+    void withdraw(double amount) {
+        lock_guard<std::mutex> lock {mtx};
+        account->withdraw(amount);
+    }
+};
+
+static unsigned int failures {0};
+
+static void check(bool ok, const string &what) {
+    cout << (ok ? "  ok    " : "  FAIL  ") << what << endl;
+    failures += !ok;
+}
+
+template <typename Work>
+static void run_threads(unsigned int threads, Work work) {
+    vector<thread> workers;
+    for (unsigned int t = 0; t < threads; t++)
+        workers.emplace_back(work, t);
+    for (thread &worker : workers)
+        worker.join();
+}
+
+// Many threads on one account; every invariant must hold however the threads interleave
+static void stress_concurrent() {
+    constexpr unsigned int threads = 8;
+
+    // 8 threads race to take 1 cent at a time from $100.00: exactly 10000 may succeed
+    Concurrent_Account checking {Account_Type::checking, "Race", 100.00};
+    vector<size_t> taken(threads, 0);
+    run_threads(threads, [&](unsigned int t) {
+        for (int i = 0; i < 5000; i++) {
+            try {
+                checking.withdraw(0.01);
+                taken[t]++;
+            }
+            catch (const InsufficientFundsException &) {
+            }
+        }
+    });
+    size_t total_taken {0};
+    for (size_t n : taken)
+        total_taken += n;
+    check(total_taken == 10000 && checking.get_balance().get_cents() == 0, "no overdraft, no lost cent (checking)");
+
+    // Deposits and withdrawals mixed: the final balance is the start plus everything that succeeded
+    Concurrent_Account savings {Account_Type::savings, "Mixed", 1000.00, 0.0};
+    vector<long long> net(threads, 0);
+    run_threads(threads, [&](unsigned int t) {
+        mt19937 rng {t};
+        for (int i = 0; i < 100000; i++) {
+            long long cents = 1 + rng() % 5000;
+            if (rng() & 1) {
+                net[t] += savings.deposit(Money::from_cents(cents)) ? cents : 0;
+            } else {
+                try {
+                    savings.withdraw(Money::from_cents(cents));
+                    net[t] -= cents;
+                }
+                catch (const InsufficientFundsException &) {
+                }
+            }
+        }
+    });
+    long long expected {100000};
+    for (long long n : net)
+        expected += n;
+    check(savings.get_balance().get_cents() == expected, "balance equals the sum of successful transactions (savings)");
+
+    // 8 threads each try 100 withdrawals of 10% from one trust: exactly 3 succeed, each within 20%
+    // of the balance it was taken from
+    Concurrent_Account trust {Account_Type::trust, "Trust", 10000.00, 0.0};
+    vector<size_t> allowed(threads, 0);
+    run_threads(threads, [&](unsigned int t) {
+        for (int i = 0; i < 100; i++) {
+            try {
+                trust.withdraw(1000.00);
+                allowed[t]++;
+            }
+            catch (const IllegalTrustWithdrawalException &) {
+            }
+        }
+    });
+    size_t total_allowed {0};
+    for (size_t n : allowed)
+        total_allowed += n;
+    check(total_allowed == 3 && trust.get_num_withdrawals() == 3 && trust.get_balance().get_cents() == 700000,
+          "exactly 3 trust withdrawals of $1000.00 from $10000.00");
+}
+
+// Threads hammering a small set of accounts with deposit/withdraw pairs: CAS vs mutex
+template <typename Shared>
+static double pairs_per_second(vector<unique_ptr<Shared>> &accounts, unsigned int threads, int pairs_per_thread) {
+    auto start = chrono::steady_clock::now();
+    run_threads(threads, [&](unsigned int t) {
+        size_t n = accounts.size();
+        for (int i = 0; i < pairs_per_thread; i++) {
+            Shared &acc = *accounts[(t * 7919 + i) % n];
+            acc.deposit(10.00);
+            acc.withdraw(10.00);
+        }
+    });
+    return threads * static_cast<double>(pairs_per_thread) / (ms_since(start) / 1000.0);
+}
+
+static void bench_contention() {
+    constexpr int pairs_per_thread = 200000;
+    cout << setw(22) << left << "" << right << setw(18) << "CAS (M pairs/s)" << setw(18) << "mutex (M pairs/s)" << endl;
+    for (size_t account_count : {size_t{1}, size_t{64}}) {
+        for (unsigned int threads : {1u, 2u, 4u, 8u}) {
+            vector<unique_ptr<Concurrent_Account>> lock_free;
+            vector<unique_ptr<Locked_Account>> locked;
+            for (size_t i = 0; i < account_count; i++) {
+                lock_free.push_back(make_unique<Concurrent_Account>(Account_Type::checking, "Shared", 1000.00));
+                locked.push_back(make_unique<Locked_Account>(make_unique<Checking_Account>("Shared", 1000.00)));
+            }
+            double cas = pairs_per_second(lock_free, threads, pairs_per_thread);
+            double mutex = pairs_per_second(locked, threads, pairs_per_thread);
+            cout << setw(3) << account_count << " account(s), " << threads << " thr" << (threads == 1 ? " " : "s")
+                 << fixed << setprecision(1) << setw(16) << cas / 1e6 << setw(18) << mutex / 1e6 << endl;
+        }
+    }
+}
+
+// 10M mixed single-account transactions (Transaction from Transaction_Processor.h): virtual calls through Account* vs visitors on Account_Variant
+static void bench_dispatch(size_t account_count, size_t transaction_count) {
+    mt19937_64 rng {15};
+    vector<unique_ptr<Account>> objects;
+    vector<Account_Variant> variants;
+    objects.reserve(account_count);
+    variants.reserve(account_count);
+    for (size_t i = 0; i < account_count; i++) {
+        string name = "Account " + to_string(i);
+        Money balance = static_cast<double>(1000 + rng() % 19000);
+        double rate = (rng() % 500) / 100.0;
+        switch (rng() % 3) {
+            case 0:
+                objects.push_back(make_unique<Checking_Account>(name, balance));
+                variants.emplace_back(in_place_type<Checking_Account>, name, balance);
+                break;
+            case 1:
+                objects.push_back(make_unique<Savings_Account>(name, balance, rate));
+                variants.emplace_back(in_place_type<Savings_Account>, name, balance, rate);
+                break;
+            default:
+                objects.push_back(make_unique<Trust_Account>(name, balance, rate));
+                variants.emplace_back(in_place_type<Trust_Account>, name, balance, rate);
+        }
+    }
+    vector<Transaction> transactions(transaction_count);
+    for (Transaction &t : transactions) {
+        t.id = rng() % account_count;
+        t.kind = rng() % 5 != 0 ? Transaction_Kind::deposit : Transaction_Kind::withdraw;
+        t.amount = Money::from_cents(100 + rng() % 10000);
+    }
+
+    size_t object_ok {0};
+    auto start = chrono::steady_clock::now();
+    for (const Transaction &t : transactions) {
+        Account *acc = objects[t.id].get();
+        if (t.kind == Transaction_Kind::deposit) {
+            object_ok += acc->deposit(t.amount);
+        } else {
+            try {
+                acc->withdraw(t.amount);
+                object_ok++;
+            }
+            catch (const exception &) {
+            }
+        }
+    }
+    double o_ms = ms_since(start);
+
+    size_t variant_ok {0};
+    start = chrono::steady_clock::now();
+    for (const Transaction &t : transactions) {
+        Account_Variant &acc = variants[t.id];
+        if (t.kind == Transaction_Kind::deposit) {
+            variant_ok += deposit(acc, t.amount);
+        } else {
+            try {
+                withdraw(acc, t.amount);
+                variant_ok++;
+            }
+            catch (const exception &) {
+            }
+        }
+    }
+    double v_ms = ms_since(start);
+
+    size_t mismatches {0};
+    for (size_t i = 0; i < account_count; i++)
+        mismatches += (objects[i]->get_balance() != as_account(variants[i]).get_balance());
+    cout << fixed << setprecision(2)
+         << "virtual " << o_ms << " ms, variant " << v_ms << " ms (" << setprecision(1) << o_ms / v_ms << "x); "
+         << variant_ok << " of " << transaction_count << " succeeded"
+         << (variant_ok == object_ok ? "" : "   ** COUNT MISMATCH **") << ", "
+         << mismatches << " balances differ" << endl;
+    failures += (variant_ok != object_ok) + (mismatches != 0);
+}
+
+// Withdrawals where most are rejected: the throwing API (one unwind per rejection) vs try_withdraw
+static void bench_rejections(size_t account_count, size_t withdrawal_count, unsigned int overdraft_percent) {
+    mt19937_64 rng {16};
+    vector<unique_ptr<Account>> throwing;
+    vector<unique_ptr<Account>> result_code;
+    for (size_t i = 0; i < account_count; i++) {
+        Account_Type type = static_cast<Account_Type>(i % 3);
+        throwing.push_back(std::move(make_account(type, "Account", 1000.00, 1.0).value()));
+        result_code.push_back(std::move(make_account(type, "Account", 1000.00, 1.0).value()));
+    }
+    // Small withdrawals succeed (until a trust uses up its 3 withdrawals); overdrafts are rejected
+    vector<pair<size_t, Money>> withdrawals(withdrawal_count);
+    for (auto &w : withdrawals)
+        w = {rng() % account_count, (rng() % 100 < overdraft_percent) ? Money{1'000'000.00} : Money{0.01}};
+
+    size_t thrown {0};
+    auto start = chrono::steady_clock::now();
+    for (const auto &[id, amount] : withdrawals) {
+        try {
+            throwing[id]->withdraw(amount);
+        }
+        catch (const exception &) {
+            thrown++;
+        }
+    }
+    double t_ms = ms_since(start);
+
+    size_t rejected {0};
+    start = chrono::steady_clock::now();
+    for (const auto &[id, amount] : withdrawals)
+        rejected += !result_code[id]->try_withdraw(amount).has_value();
+    double r_ms = ms_since(start);
+
+    cout << setw(3) << overdraft_percent << "% overdrafts, " << setw(7) << rejected << " rejected: " << fixed << setprecision(2)
+         << "throwing " << setw(9) << t_ms << " ms, try_withdraw " << setw(7) << r_ms << " ms ("
+         << setprecision(1) << t_ms / r_ms << "x)"
+         << (thrown == rejected ? "" : "   ** COUNT MISMATCH **") << endl;
+    failures += (thrown != rejected);
+}
+
+// Durable ledger: logging throughput with group commit, then recovery time from the journal alone,
+// from a snapshot plus a short tail, and after a crash that tore the last group
+static vector<Money> balances_of(const Account_Ledger &ledger) {
+    vector<Money> balances;
+    for (size_t id = 0; id < ledger.size(); id++)
+        balances.push_back(ledger.get_balance(id));
+    return balances;
+}
+
+static void bench_journal(size_t transaction_count) {
+    constexpr size_t account_count = 100'000;
+    const string directory = (filesystem::temp_directory_path() / "account_journal_bench").string();
+    filesystem::remove_all(directory);
+    mt19937_64 rng {17};
+    vector<Money> expected;
+    {
+        Account_Journal journal {directory};
+        for (size_t i = 0; i < account_count; i++)
+            journal.add(static_cast<Account_Type>(i % 3), "Account " + to_string(i), 5000.00, 2.5);
+        journal.commit();
+
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < transaction_count; i++) {
+            size_t id = rng() % account_count;
+            if (rng() % 5 != 0)
+                journal.try_deposit(id, Money::from_cents(static_cast<long long>(rng() % 10000)));
+            else
+                journal.try_withdraw(id, Money::from_cents(static_cast<long long>(rng() % 10000)));
+        }
+        journal.commit();
+        double ms = ms_since(start);
+        cout << fixed << setprecision(2) << "log " << transaction_count << " transactions: " << ms << " ms ("
+             << setprecision(2) << transaction_count / ms / 1000.0 << " M/s, "
+             << filesystem::file_size(directory + "/journal.0.log") / (1 << 20) << " MiB)" << endl;
+        expected = balances_of(journal.get_ledger());
+    }
+    {
+        Account_Journal journal {directory};
+        const Recovery_Report &report = journal.get_recovery();
+        check(balances_of(journal.get_ledger()) == expected, "recover from journal: " + to_string(report.replayed)
+              + " records in " + to_string(static_cast<long long>(report.seconds * 1000)) + " ms");
+
+        auto start = chrono::steady_clock::now();
+        journal.snapshot();
+        double ms = ms_since(start);
+        for (size_t i = 0; i < 1'000'000; i++)
+            journal.try_deposit(rng() % account_count, 1.00);
+        journal.commit();
+        expected = balances_of(journal.get_ledger());
+        cout << "snapshot of " << account_count << " accounts: " << setprecision(2) << ms << " ms" << endl;
+    }
+    {
+        Account_Journal journal {directory};
+        const Recovery_Report &report = journal.get_recovery();
+        check(balances_of(journal.get_ledger()) == expected && report.snapshot_accounts == account_count,
+              "recover from snapshot + " + to_string(report.replayed) + " records in "
+              + to_string(static_cast<long long>(report.seconds * 1000)) + " ms");
+        journal.deposit(0, 1.00);
+        journal.commit();
+        expected = balances_of(journal.get_ledger());
+    }
+    {
+        // A crash in the middle of a commit: half a group at the end of the journal
+        ofstream log {directory + "/journal.1.log", ios::binary | ios::app};
+        const char torn[40] = {'A', 'J', 'R', 'N', 24, 0, 0, 0};
+        log.write(torn, sizeof torn);
+    }
+    {
+        Account_Journal journal {directory};
+        check(balances_of(journal.get_ledger()) == expected && journal.get_recovery().discarded_bytes == 40,
+              "torn last group dropped on recovery");
+    }
+    {
+        // The account count is in the snapshot header, which the checksum covers
+        fstream snapshot {directory + "/snapshot.bin", ios::binary | ios::in | ios::out};
+        snapshot.seekp(16);
+        const char accounts[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+        snapshot.write(accounts, sizeof accounts);
+    }
+    try {
+        Account_Journal journal {directory};
+        check(false, "damaged snapshot header rejected");
+    }
+    catch (const JournalIOException &) {
+        check(true, "damaged snapshot header rejected");
+    }
+    filesystem::remove_all(directory);
+
+    // A commit that fails (here the file size limit makes write() fail with EFBIG part way through)
+    // poisons the journal; reopening recovers everything committed before it
+    vector<Money> committed;
+    bool refused = false;
+    {
+        Account_Journal journal {directory, 1'000'000};
+        journal.add(Account_Type::checking, "Limited", 100.00);
+        journal.commit();
+        committed = balances_of(journal.get_ledger());
+        rlimit old_limit;
+        getrlimit(RLIMIT_FSIZE, &old_limit);
+        rlim_t log_size = static_cast<rlim_t>(filesystem::file_size(directory + "/journal.0.log"));
+        rlimit limit {log_size + 64, old_limit.rlim_max};
+        auto old_handler = signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limit);
+        for (int i = 0; i < 100; i++)
+            journal.deposit(0, 1.00);
+        try {
+            journal.commit();
+        }
+        catch (const JournalIOException &) {
+        }
+        setrlimit(RLIMIT_FSIZE, &old_limit);
+        signal(SIGXFSZ, old_handler);
+        Money before = journal.get_ledger().get_balance(0);
+        try {
+            journal.deposit(0, 1.00);
+        }
+        catch (const JournalIOException &) {
+            refused = journal.is_poisoned() && journal.get_ledger().get_balance(0) == before;
+        }
+    }
+    {
+        Account_Journal journal {directory};
+        check(refused && balances_of(journal.get_ledger()) == committed && journal.get_recovery().discarded_bytes == 0,
+              "failed commit poisons the journal, reopening recovers the committed state");
+    }
+    filesystem::remove_all(directory);
+}
+
+// Memory-mapped book: the same transactions as a ledger give the same balances and survive reopening;
+// then a large book is written once and reopened, queried and scanned
+static void bench_store(size_t account_count) {
+    const string path = (filesystem::temp_directory_path() / "account_store_bench.dat").string();
+    filesystem::remove(path);
+    {
+        mt19937_64 rng {18};
+        Account_Ledger ledger;
+        Account_Store store {path};                       // starts small, so it has to grow a few times
+        for (size_t i = 0; i < 100'000; i++) {
+            Account_Type type = static_cast<Account_Type>(i % 3);
+            ledger.add(type, "Account " + to_string(i), 2000.00, 3.0);
+            store.add(type, "Account " + to_string(i), 2000.00, 3.0);
+        }
+        size_t differ {0};
+        for (size_t i = 0; i < 1'000'000; i++) {
+            size_t id = rng() % ledger.size();
+            Money amount = Money::from_cents(static_cast<long long>(rng() % 100000));
+            if (rng() & 1)
+                differ += ledger.try_deposit(id, amount).has_value() != store.try_deposit(id, amount).has_value();
+            else
+                differ += ledger.try_withdraw(id, amount).has_value() != store.try_withdraw(id, amount).has_value();
+        }
+        check(differ == 0 && balances_of(ledger) == [&] {
+                  vector<Money> balances;
+                  for (size_t id = 0; id < store.size(); id++)
+                      balances.push_back(store.get_balance(id));
+                  return balances;
+              }(), "store follows the same rules as the ledger");
+        store.flush();
+        Account_Store reopened {path};
+        bool same = reopened.size() == ledger.size();
+        for (size_t id = 0; same && id < ledger.size(); id++)
+            same = reopened.get_balance(id) == ledger.get_balance(id) && reopened.get_name(id) == ledger.get_name(id)
+                && reopened.get_num_withdrawals(id) == ledger.get_num_withdrawals(id);
+        check(same, "store reopens with every balance, name and withdrawal count");
+    }
+    {
+        // A zero record capacity would make the next grow loop forever
+        fstream file {path, ios::binary | ios::in | ios::out};
+        file.seekp(24);
+        const char capacity[8] = {};
+        file.write(capacity, sizeof capacity);
+    }
+    try {
+        Account_Store damaged {path};
+        check(false, "store with a zero capacity rejected");
+    }
+    catch (const StoreIOException &) {
+        check(true, "store with a zero capacity rejected");
+    }
+    filesystem::remove(path);
+
+    auto start = chrono::steady_clock::now();
+    {
+        Account_Store store {path, account_count, account_count * 16};
+        char name[32];
+        for (size_t i = 0; i < account_count; i++) {
+            int length = snprintf(name, sizeof name, "Account %zu", i);
+            store.add(static_cast<Account_Type>(i % 3), string_view{name, static_cast<size_t>(length)},
+                      Money::from_cents(static_cast<long long>(i % 2'000'000)), 2.0);
+        }
+        store.flush();
+    }
+    cout << fixed << setprecision(2) << "create " << account_count << " accounts: " << ms_since(start) << " ms ("
+         << filesystem::file_size(path) / (1 << 20) << " MiB)" << endl;
+
+    start = chrono::steady_clock::now();
+    Account_Store store {path};
+    cout << "open: " << setprecision(3) << ms_since(start) << " ms" << endl;
+
+    // The first pass faults the pages in (from the page cache, or the disk on a cold start)
+    for (int pass = 1; pass <= 2; pass++) {
+        start = chrono::steady_clock::now();
+        long long total {0};
+        for (size_t id = 0; id < store.size(); id++)
+            total += store.get_balance(id).get_cents();
+        cout << "scan all balances, pass " << pass << ": " << setprecision(2) << ms_since(start) << " ms (total "
+             << Money::from_cents(total) << ")" << endl;
+    }
+
+    // The first write to a clean page takes a write fault, which the filesystem may make expensive
+    // (ext4 on a slow disk: hundreds of microseconds; tmpfs: nothing) - set TMPDIR to compare. Each
+    // updated page is later written back whole, so flush grows with the distinct pages touched.
+    mt19937_64 rng {18};
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < 10'000; i++)
+        store.deposit(rng() % account_count, 10.00);
+    cout << "10K random in-place deposits: " << ms_since(start) << " ms";
+    start = chrono::steady_clock::now();
+    store.flush();
+    cout << ", flush: " << ms_since(start) << " ms" << endl;
+
+    // For scale: building heap objects for the first 1M accounts
+    start = chrono::steady_clock::now();
+    vector<unique_ptr<Account>> objects;
+    for (size_t id = 0; id < 1'000'000 && id < store.size(); id++)
+        objects.push_back(std::move(make_account(store.get_type(id), string{store.get_name(id)},
+                                                 store.get_balance(id), store.get_int_rate(id)).value()));
+    cout << "construct 1M objects from it: " << ms_since(start) << " ms" << endl;
+    filesystem::remove(path);
+}
+
+// Sharded processor: random transactions on a 1M account ledger at growing thread counts, checked
+// against one thread applying them in order through the ledger's own try_ functions
+static void bench_processor(size_t transaction_count) {
+    constexpr size_t account_count = 1'000'000;
+    Account_Ledger book;
+    book.reserve(account_count);
+    mt19937_64 rng {19};
+    for (size_t i = 0; i < account_count; i++)
+        book.add(static_cast<Account_Type>(i % 3), "Account " + to_string(i), Money::from_cents(rng() % 2'000'000),
+                 2.5);
+    auto make_transactions = [&](size_t count, bool deposits_only) {
+        vector<Transaction> transactions(count);
+        for (Transaction &transaction : transactions) {
+            transaction.id = rng() % account_count;
+            transaction.amount = Money::from_cents(static_cast<long long>(rng() % 20000));
+            transaction.kind = deposits_only || rng() % 5 != 0 ? Transaction_Kind::deposit : Transaction_Kind::withdraw;
+        }
+        return transactions;
+    };
+
+    {
+        // Deposits commute, so every thread count has to land on exactly the serial balances
+        vector<Transaction> transactions = make_transactions(10'000'000, true);
+        Account_Ledger serial {book};
+        unsigned int epoch = serial.begin_epoch();
+        for (const Transaction &transaction : transactions)
+            serial.try_deposit(transaction.id, transaction.amount);
+        vector<Balance_Change> serial_changes = serial.changes_since(epoch);
+        for (unsigned int threads : {1u, 2u, 4u}) {
+            Account_Ledger parallel {book};
+            parallel.begin_epoch();
+            Transaction_Processor processor {parallel, threads, 1024};   // small rings: plenty of full-ring retries
+            Processor_Report report = processor.process(transactions);
+            vector<Balance_Change> changes = parallel.changes_since(epoch);
+            bool same_changes = changes.size() == serial_changes.size()
+                && equal(changes.begin(), changes.end(), serial_changes.begin(),
+                         [](const Balance_Change &a, const Balance_Change &b) { return a.id == b.id; });
+            check(balances_of(parallel) == balances_of(serial) && report.deposits == transactions.size()
+                  && same_changes, to_string(threads) + " thread deposits match serial");
+        }
+    }
+
+    vector<Transaction> transactions = make_transactions(transaction_count, false);
+    {
+        // One thread keeps the input order, withdrawals included
+        vector<Transaction> sample {transactions.begin(), transactions.begin() + 10'000'000};
+        Account_Ledger serial {book};
+        size_t applied {0};
+        for (const Transaction &transaction : sample)
+            applied += transaction.kind == Transaction_Kind::deposit
+                ? serial.try_deposit(transaction.id, transaction.amount).has_value()
+                : serial.try_withdraw(transaction.id, transaction.amount).has_value();
+        Account_Ledger parallel {book};
+        Processor_Report report = Transaction_Processor{parallel, 1}.process(sample);
+        check(balances_of(parallel) == balances_of(serial) && report.deposits + report.withdrawals == applied,
+              "1 thread mixed transactions match serial");
+    }
+    {
+        // A deposit that would overflow a balance is a rejection, not an exception on a worker thread
+        Account_Ledger ledger;
+        ledger.add(Account_Type::checking, "Full", Money::from_cents(numeric_limits<long long>::max() - 50));
+        ledger.add(Account_Type::checking, "Other", 100.00);
+        vector<Transaction> overflowing {{0, 1.00, Transaction_Kind::deposit}, {1, 1.00, Transaction_Kind::deposit}};
+        Processor_Report report = Transaction_Processor{ledger, 2}.process(overflowing);
+        check(report.overflows == 1 && report.deposits == 1
+              && ledger.get_balance(0) == Money::from_cents(numeric_limits<long long>::max() - 50),
+              "overflowing deposit counted and skipped");
+    }
+
+    vector<unsigned int> thread_counts {1, 2, 4};
+    unsigned int cores = thread::hardware_concurrency();
+    if (cores > 4)
+        thread_counts.push_back(cores);
+    for (unsigned int threads : thread_counts) {
+        Account_Ledger ledger {book};
+        Processor_Report report = Transaction_Processor{ledger, threads}.process(transactions);
+        size_t total = report.deposits + report.withdrawals + report.rejected_deposits + report.insufficient_funds
+            + report.illegal_trust_withdrawals + report.overflows + report.unknown_accounts;
+        check(total == transactions.size(), to_string(threads) + " threads account for every transaction");
+        cout << fixed << setprecision(2) << setw(2) << threads << " threads: " << report.seconds * 1000 << " ms ("
+             << report.transactions_per_second / 1e6 << " M/s, " << report.withdrawals << " withdrawals, "
+             << report.insufficient_funds + report.illegal_trust_withdrawals << " rejected)" << endl;
+    }
+}
+
+// Printing a book: operator<< and std::endl per account (what display did) vs display() formatting into
+// a Print_Buffer and writing it a batch at a time. Both files have to come out identical.
+static bool same_file(const string &a, const string &b) {
+    ifstream first {a, ios::binary}, second {b, ios::binary};
+    vector<char> x(1 << 20), y(1 << 20);
+    while (first && second) {
+        first.read(x.data(), x.size());
+        second.read(y.data(), y.size());
+        if (first.gcount() != second.gcount() || !equal(x.begin(), x.begin() + first.gcount(), y.begin()))
+            return false;
+    }
+    return first.eof() && second.eof();
+}
+
+static void bench_print(size_t account_count) {
+    {
+        // Print_Buffer's doubles against the stream's, ties and huge values included
+        mt19937_64 rng {20};
+        ostringstream stream;
+        stream << fixed << setprecision(2);
+        Print_Buffer buffer;
+        for (int i = 0; i < 1'000'000; i++) {
+            double value = i % 3 == 0 ? (static_cast<long long>(rng() % 2'000'000) - 1'000'000) / 8.0
+                         : i % 3 == 1 ? uniform_real_distribution<double>{-1e6, 1e6}(rng)
+                         : ldexp(static_cast<double>(rng() % 1000), static_cast<int>(rng() % 200) - 100);
+            stream << value << ' ';
+            buffer.append(value).append(' ');
+        }
+        check(string_view(buffer.get_data(), buffer.size()) == stream.str(), "1M doubles format like the stream");
+    }
+
+    mt19937_64 rng {20};
+    vector<unique_ptr<Account>> objects;
+    vector<Account *> accounts;
+    objects.reserve(account_count);
+    for (size_t i = 0; i < account_count; i++) {
+        string name = "Account " + to_string(i);
+        Money balance = Money::from_cents(static_cast<long long>(rng() % 2'000'000));
+        double rate = (rng() % 500) / 100.0;
+        if (i % 3 == 0)
+            objects.push_back(make_unique<Checking_Account>(name, balance));
+        else if (i % 3 == 1)
+            objects.push_back(make_unique<Savings_Account>(name, balance, rate));
+        else
+            objects.push_back(make_unique<Trust_Account>(name, balance, rate));
+        accounts.push_back(objects.back().get());
+    }
+
+    const string streamed = (filesystem::temp_directory_path() / "accounts_streamed.txt").string();
+    const string buffered = (filesystem::temp_directory_path() / "accounts_buffered.txt").string();
+    {
+        ofstream os {streamed};
+        auto start = chrono::steady_clock::now();
+        os << "\n=== Accounts===========================================" << endl;
+        for (const Account *acc : accounts)
+            os << *acc << endl;
+        cout << "operator<< + endl: " << fixed << setprecision(2) << ms_since(start) << " ms" << endl;
+    }
+    {
+        ofstream os {buffered};
+        auto start = chrono::steady_clock::now();
+        display(os, accounts);
+        double ms = ms_since(start);
+        cout << "display, buffered: " << ms << " ms (" << filesystem::file_size(buffered) / ms / 1000.0
+             << " MB/s)" << endl;
+    }
+    check(same_file(streamed, buffered), "buffered output identical to operator<<");
+    filesystem::remove(streamed);
+    filesystem::remove(buffered);
+}
+
+// Routing transactions by account name: the registry's hash index vs std::unordered_map vs walking
+// the vector of accounts (the only option Account_Util had), on 1M accounts
+static void bench_registry(size_t transaction_count) {
+    constexpr size_t account_count = 1'000'000;
+    mt19937_64 rng {21};
+    Account_Registry registry;
+    vector<Account_Variant> accounts;
+    unordered_map<string, size_t> by_name;
+    registry.reserve(account_count);
+    accounts.reserve(account_count);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < account_count; i++) {
+        Account_Type type = static_cast<Account_Type>(i % 3);
+        string name = "Customer " + to_string(rng() % 1'000'000'000'000);
+        if (registry.contains(name))
+            continue;
+        registry.add(type, name, 5000.00, 2.5);
+        by_name.emplace(name, accounts.size());
+        if (type == Account_Type::checking)
+            accounts.emplace_back(in_place_type<Checking_Account>, name, 5000.00);
+        else if (type == Account_Type::savings)
+            accounts.emplace_back(in_place_type<Savings_Account>, name, 5000.00, 2.5);
+        else
+            accounts.emplace_back(in_place_type<Trust_Account>, name, 5000.00, 2.5);
+    }
+    cout << "register " << registry.size() << " accounts: " << fixed << setprecision(2) << ms_since(start) << " ms"
+         << endl;
+
+    const Account_Variant *first = &registry.get(0);
+    Account_Registry grown;
+    grown.add(Account_Type::checking, "First", 10.00);
+    const Account_Variant *kept = &grown.get(0);
+    for (size_t i = 0; i < 100'000; i++)
+        grown.add(Account_Type::savings, "Other " + to_string(i), 10.00, 1.0);
+    check(&grown.get(0) == kept && grown.find("First").value() == 0 && first == &registry.get(0)
+          && !grown.add(Account_Type::trust, "First", 1.00) && grown.find("Nobody").error() == Account_Error::unknown_account,
+          "handles survive growth, duplicate and unknown names rejected");
+    size_t thrown {0};
+    try {
+        grown.add_account(Account_Type::trust, "First", 1.00);
+    }
+    catch (const DuplicateAccountException &) {
+        thrown++;
+    }
+    try {
+        grown.withdraw("Nobody", 1.00);
+    }
+    catch (const UnknownAccountException &) {
+        thrown++;
+    }
+    check(thrown == 2 && grown.deposit("First", 5.00), "throwing calls raise DuplicateAccount / UnknownAccount");
+
+    vector<string> names(transaction_count);
+    vector<Money> amounts(transaction_count);
+    for (size_t i = 0; i < transaction_count; i++) {
+        names[i] = string{as_account(accounts[rng() % accounts.size()]).get_name()};
+        amounts[i] = Money::from_cents(static_cast<long long>(rng() % 10000));
+    }
+
+    size_t routed {0};
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < transaction_count; i++)
+        routed += registry.try_deposit(names[i], amounts[i]).has_value();
+    double registry_ms = ms_since(start);
+
+    size_t mapped {0};
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < transaction_count; i++) {
+        auto found = by_name.find(names[i]);
+        if (found != by_name.end())
+            mapped += try_deposit(accounts[found->second], amounts[i]).has_value();
+    }
+    double map_ms = ms_since(start);
+
+    // A linear walk is hopeless at this size, so it only gets the first 100 transactions
+    constexpr size_t walked = 100;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < walked; i++)
+        for (Account_Variant &acc : accounts)
+            if (as_account(acc).get_name() == names[i]) {
+                try_deposit(acc, Money{});
+                break;
+            }
+    double walk_ms = ms_since(start) * transaction_count / walked;
+
+    bool same = routed == transaction_count && mapped == transaction_count;
+    for (size_t id = 0; id < accounts.size() && same; id++)
+        same = as_account(registry.get(id)).get_balance() == as_account(accounts[id]).get_balance();
+    check(same, "registry and unordered_map routing give the same balances");
+    cout << "route " << transaction_count << " named transactions:" << endl
+         << "  registry       " << setw(10) << registry_ms << " ms (" << transaction_count / registry_ms / 1000.0
+         << " M/s)" << endl
+         << "  unordered_map  " << setw(10) << map_ms << " ms (" << transaction_count / map_ms / 1000.0 << " M/s)"
+         << endl
+         << "  vector walk    " << setw(10) << setprecision(0) << walk_ms / 1000.0 << " s (estimated from " << walked
+         << ")" << endl;
+}
+
+// 10M accounts, one heap block each through make_account vs slots in per-type slab pools: creation,
+// one deposit pass in creation order, and destruction
+template <typename Pointer, typename Make>
+static void time_allocation(const char *label, size_t account_count, Make make, vector<Money> &balances) {
+    mt19937_64 rng {22};
+    vector<Pointer> accounts;
+    accounts.reserve(account_count);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < account_count; i++)
+        accounts.push_back(make(static_cast<Account_Type>(rng() % 3), "Account " + to_string(i),
+                                Money::from_cents(static_cast<long long>(rng() % 2'000'000)), 2.5));
+    double create_ms = ms_since(start);
+    start = chrono::steady_clock::now();
+    for (Pointer &acc : accounts)
+        acc->deposit(10.00);
+    double pass_ms = ms_since(start);
+    balances.clear();
+    for (Pointer &acc : accounts)
+        balances.push_back(acc->get_balance());
+    start = chrono::steady_clock::now();
+    accounts.clear();
+    double destroy_ms = ms_since(start);
+    cout << setw(14) << left << label << right << fixed << setprecision(2) << setw(10) << create_ms << " ms ("
+         << setw(5) << account_count / create_ms / 1000.0 << " M/s)" << setw(10) << pass_ms << " ms" << setw(10)
+         << destroy_ms << " ms" << endl;
+}
+
+static void bench_pool(size_t account_count) {
+    cout << setw(14) << "" << setw(25) << "create" << setw(13) << "deposit pass" << setw(13) << "destroy" << endl;
+    vector<Money> from_heap, from_pool;
+    time_allocation<unique_ptr<Account>>("make_account", account_count,
+        [](Account_Type type, string name, Money balance, double rate) {
+            return std::move(make_account(type, std::move(name), balance, rate).value());
+        }, from_heap);
+    Account_Pools pools;
+    time_allocation<Pooled_Account>("Account_Pools", account_count,
+        [&pools](Account_Type type, string name, Money balance, double rate) {
+            return std::move(pools.make(type, std::move(name), balance, rate).value());
+        }, from_pool);
+    check(from_heap == from_pool, "pooled accounts behave like heap ones");
+
+    // Slots freed in the middle of a pool are handed out again before the pool grows
+    Pooled_Account kept = std::move(pools.make(Account_Type::trust, "Kept", 1.00, 1.0).value());
+    Pooled_Account freed = std::move(pools.make(Account_Type::trust, "Freed", 1.00, 1.0).value());
+    Account *slot = freed.get();
+    freed.reset();
+    Pooled_Account reused = std::move(pools.make(Account_Type::trust, "Reused", 1.00, 1.0).value());
+    check(reused.get() == slot && pools.get_live(Account_Type::trust) == 2
+          && pools.get_live(Account_Type::checking) == 0, "freed slots are reused");
+}
+
+// Daily statements on a big book: 0.1% of the accounts change each day, and each statement asks the
+// ledger for the changes since the previous one instead of listing every account
+static void bench_statements(size_t account_count, int days) {
+    mt19937_64 rng {23};
+    Account_Ledger ledger;
+    ledger.reserve(account_count);
+    for (size_t i = 0; i < account_count; i++)
+        ledger.add(static_cast<Account_Type>(i % 3), "", Money::from_cents(static_cast<long long>(rng() % 2'000'000)),
+                   2.5);
+    size_t daily = account_count / 1000;
+
+    unsigned int last = ledger.begin_epoch();
+    {
+        // First day checked against a full comparison of the balances
+        vector<long long> before(account_count);
+        for (size_t id = 0; id < account_count; id++)
+            before[id] = ledger.get_balance(id).get_cents();
+        for (size_t i = 0; i < daily; i++)
+            ledger.try_withdraw(rng() % account_count, Money::from_cents(static_cast<long long>(rng() % 10000)));
+        vector<Balance_Change> changes = ledger.changes_since(last);
+        size_t differing {0};
+        bool matches = true;
+        for (size_t id = 0; id < account_count; id++)
+            differing += ledger.get_balance(id).get_cents() != before[id];
+        for (const Balance_Change &change : changes)
+            matches &= change.balance == ledger.get_balance(change.id)
+                && change.balance.get_cents() != before[change.id];
+        check(matches && changes.size() == differing, "statement lists exactly the " + to_string(differing)
+              + " changed balances");
+        last = ledger.begin_epoch();
+    }
+
+    double statement_ms {0}, full_ms {0};
+    size_t listed {0};
+    Money total;
+    for (int day = 1; day < days; day++) {
+        for (size_t i = 0; i < daily; i++) {
+            size_t id = rng() % account_count;
+            Money amount = Money::from_cents(static_cast<long long>(rng() % 10000));
+            if (rng() % 2)
+                ledger.try_deposit(id, amount);
+            else
+                ledger.try_withdraw(id, amount);
+        }
+        auto start = chrono::steady_clock::now();
+        vector<Balance_Change> changes = ledger.changes_since(last);
+        last = ledger.begin_epoch();
+        statement_ms += ms_since(start);
+        listed += changes.size();
+
+        // What display does today: every balance, every time
+        start = chrono::steady_clock::now();
+        vector<Balance_Change> everything;
+        everything.reserve(account_count);
+        for (size_t id = 0; id < account_count; id++)
+            everything.push_back(Balance_Change{id, ledger.get_balance(id)});
+        full_ms += ms_since(start);
+        total += everything.back().balance;
+    }
+    // A statement covering the whole period lists each account once, however often it changed
+    vector<Balance_Change> month = ledger.changes_since(1);
+    auto out_of_order = [](const Balance_Change &a, const Balance_Change &b) { return a.id >= b.id; };
+    bool sorted_once = adjacent_find(month.begin(), month.end(), out_of_order) == month.end();
+    check(sorted_once && month.size() <= daily * days, "period statement: " + to_string(month.size())
+          + " accounts, each once");
+    cout << fixed << setprecision(2) << days - 1 << " daily statements of about " << listed / (days - 1)
+         << " changed accounts: " << statement_ms / (days - 1) << " ms each, full listing "
+         << full_ms / (days - 1) << " ms each" << endl;
+}
+
+// Product rules as data: policy-driven accounts against the account classes, then the rule evaluation
+// itself on flat arrays - the rules hand-written as Trust_Account had them, the constexpr Trust_Account::rules,
+// a trust row compiled at run time, and 1000 random product variants
+struct Rule_State {
+    Money balance;
+    int withdrawals;
+};
+
+static void bench_policies(size_t transaction_count) {
+    mt19937_64 rng {24};
+    const vector<Compiled_Policy> builtin = compile_policies({Checking_Account::policy, Savings_Account::policy,
+                                                              Trust_Account::policy});
+    {
+        vector<unique_ptr<Account>> classes;
+        vector<unique_ptr<Account>> policies;
+        for (size_t i = 0; i < 30'000; i++) {
+            Account_Type type = static_cast<Account_Type>(i % 3);
+            Money balance = Money::from_cents(static_cast<long long>(rng() % 2'000'000));
+            classes.push_back(std::move(make_account(type, "Account", balance, 2.5).value()));
+            policies.push_back(make_unique<Policy_Account>(builtin[i % 3], "Account", balance,
+                                                           type == Account_Type::checking ? 0.0 : 2.5));
+        }
+        bool same = true;
+        for (size_t i = 0; i < 1'000'000; i++) {
+            size_t id = rng() % classes.size();
+            Money amount = Money::from_cents(static_cast<long long>(rng() % 800'000) - 1000);
+            bool is_deposit = rng() % 2;
+            Account &object = *classes[id];
+            Account &policy = *policies[id];
+            Expected<Money> expected = is_deposit ? object.try_deposit(amount) : object.try_withdraw(amount);
+            Expected<Money> actual = is_deposit ? policy.try_deposit(amount) : policy.try_withdraw(amount);
+            same &= expected.has_value() == actual.has_value()
+                && (expected ? expected.value() == actual.value() : expected.error() == actual.error());
+        }
+        check(same, "policy rows behave like Checking_Account, Savings_Account and Trust_Account");
+    }
+
+    vector<Account_Policy> variants;
+    for (int i = 0; i < 1000; i++)
+        variants.push_back(Account_Policy{"Variant", rng() % 2 == 0, Money::from_cents(100'000 + rng() % 1'000'000),
+                                          Money::from_cents(rng() % 10'000),
+                                          Money::from_cents(rng() % 3 == 0 ? 150 : 0),
+                                          static_cast<int>(rng() % 6), static_cast<int>(rng() % 50)});
+    const vector<Compiled_Policy> compiled = compile_policies(variants);
+    const vector<Compiled_Policy> trust_row = compile_policies({Trust_Account::policy});
+
+    constexpr size_t account_count = 100'000;
+    vector<size_t> ids(transaction_count);
+    vector<Money> amounts(transaction_count);
+    vector<unsigned short> products(account_count);
+    for (size_t i = 0; i < transaction_count; i++) {
+        ids[i] = rng() % account_count;
+        amounts[i] = Money::from_cents(static_cast<long long>(rng() % 800'000));
+    }
+    for (unsigned short &product : products)
+        product = static_cast<unsigned short>(rng() % compiled.size());
+
+    auto run = [&](const char *label, auto rules_of) {
+        vector<Rule_State> states(account_count, Rule_State{Money::from_cents(1'000'000), 0});
+        size_t applied {0};
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < transaction_count; i++) {
+            Rule_State &state = states[ids[i]];
+            const auto &rules = rules_of(ids[i]);
+            Expected<Money> result = i % 2 ? rules.deposit(state.balance, amounts[i], 2.5)
+                                           : rules.withdraw(state.balance, state.withdrawals, amounts[i]);
+            if (result) {
+                state.balance = result.value();
+                applied++;
+            }
+            if (i % 8 == 7)
+                state.withdrawals = 0;      // new statement period
+        }
+        double ms = ms_since(start);
+        cout << setw(24) << left << label << right << fixed << setprecision(2) << setw(10) << ms << " ms ("
+             << setw(6) << transaction_count / ms / 1000.0 << " M/s, " << applied << " applied)" << endl;
+        return states;
+    };
+
+    // Trust_Account's rules as they were written before the policy table
+    struct Hand_Written {
+        Expected<Money> deposit(Money balance, Money amount, double int_rate) const {
+            if (amount >= 5000.00)
+                amount += 50.00;
+            amount += amount.scaled(int_rate/100);
+            if (amount < Money{})
+                return Account_Error::negative_deposit;
+            return balance + amount;
+        }
+        Expected<Money> withdraw(Money balance, int &withdrawals, Money amount) const {
+            if (withdrawals >= 3 || (amount * 100 > balance * 20))
+                return Account_Error::illegal_trust_withdrawal;
+            ++withdrawals;
+            if (balance - amount >= Money{})
+                return balance - amount;
+            return Account_Error::insufficient_funds;
+        }
+    } hand_written;
+    auto by_hand = run("hand-written trust", [&](size_t) -> const Hand_Written & { return hand_written; });
+    auto folded = run("constexpr Trust::rules",
+                      [](size_t) -> const Compiled_Policy & { return Trust_Account::rules; });
+    auto table = run("trust row from table", [&](size_t) -> const Compiled_Policy & { return trust_row[0]; });
+    run("1000 product variants", [&](size_t id) -> const Compiled_Policy & { return compiled[products[id]]; });
+    bool same = true;
+    for (size_t id = 0; id < account_count; id++)
+        same &= by_hand[id].balance == folded[id].balance && folded[id].balance == table[id].balance;
+    check(same, "all three trust evaluators agree");
+}
+
+// An account type that limits incoming money - transfers must not get around it
+class Capped_Account : public Checking_Account {
+private:
+    Money cap;
+protected:
+    virtual Expected<Money> check_credit(Money amount) const override {
+        Expected<Money> credited = Checking_Account::check_credit(amount);
+        if (credited && credited.value() > cap)
+            return Account_Error::illegal_balance;
+        return credited;
+    }
+public:
+    Capped_Account(string name, Money balance, Money cap) : Checking_Account {name, balance}, cap {cap} {}
+};
+
+// Transfers between account objects: correctness under contention, then throughput at 1-64 threads
+// with Zipf-distributed account popularity (a few accounts take most of the traffic), one lock pair
+// per transfer vs batches of 16
+static void bench_transfers(size_t transfer_count) {
+    {
+        // Money only moves between checking accounts, so the total has to stay put; opposite-direction
+        // transfers on the same pairs would deadlock with unordered locking
+        Transfer_Engine engine {4};
+        vector<unique_ptr<Account>> accounts;
+        for (int i = 0; i < 64; i++)
+            accounts.push_back(make_unique<Checking_Account>("Shared", 1000.00));
+        run_threads(8, [&](unsigned int t) {
+            mt19937_64 rng {t};
+            vector<Transfer> batch;
+            for (int i = 0; i < 20'000; i++) {
+                Account &a = *accounts[rng() % 64];
+                Account &b = *accounts[rng() % 64];
+                Money amount = Money::from_cents(static_cast<long long>(rng() % 50'000));
+                engine.try_transfer(a, b, amount);
+                batch.push_back(Transfer{&b, &a, amount});
+            }
+            engine.transfer_all(batch, 16);
+        });
+        Money total;
+        bool negative = false;
+        for (auto &acc : accounts) {
+            total += acc->get_balance();
+            negative |= acc->get_balance() < Money{};
+        }
+        check(total == Money{64'000.00} && !negative, "8 threads of crossing transfers: no deadlock, total kept");
+    }
+    {
+        Transfer_Engine engine;
+        Trust_Account trust {"Trust", 10'000.00};
+        Checking_Account checking {"Checking", 0.0};
+        bool allowed = true;
+        for (int i = 0; i < 3; i++)
+            allowed &= engine.try_transfer(trust, checking, 100.00).has_value();
+        Expected<Money> fourth = engine.try_transfer(trust, checking, 100.00);
+        Expected<Money> too_big = engine.try_transfer(checking, trust, 500.00);
+        check(allowed && !fourth && fourth.error() == Account_Error::illegal_trust_withdrawal
+              && !too_big && too_big.error() == Account_Error::insufficient_funds
+              && checking.get_balance() == Money{300.00} && trust.get_balance() == Money{9'700.00},
+              "Trust_Account limits apply and rejected transfers leave both sides unchanged");
+    }
+    {
+        // A deposit of $5000 into a trust would add interest and the $50 bonus; a transfer must not
+        Transfer_Engine engine;
+        Checking_Account checking {"Checking", 10'000.00};
+        Savings_Account savings {"Savings", 0.0, 5.0};
+        Trust_Account trust {"Trust", 0.0, 5.0};
+        engine.transfer(checking, savings, 1'000.00);
+        engine.transfer(checking, trust, 5'000.00);
+        bool rejected = false;
+        try {
+            Transfer_Engine too_many_stripes {64};
+        }
+        catch (const invalid_argument &) {
+            rejected = true;
+        }
+        check(engine.get_balance(savings) == Money{1'000.00} && engine.get_balance(trust) == Money{5'000.00}
+              && engine.get_balance(checking) == Money{4'000.00} && rejected,
+              "transfers credit the plain amount, no interest or bonus");
+    }
+    {
+        Transfer_Engine engine;
+        Trust_Account trust {"Trust", 10'000.00};
+        Capped_Account capped {"Capped", 0.0, 150.00};
+        Expected<Money> fits = engine.try_transfer(trust, capped, 100.00);
+        Expected<Money> over_cap = engine.try_transfer(trust, capped, 100.00);
+        Expected<Money> negative = engine.try_transfer(trust, capped, -1.00);
+        bool rejected = false;
+        try {
+            engine.transfer_all({Transfer{&trust, &capped, 1.00}}, 0);
+        }
+        catch (const invalid_argument &) {
+            rejected = true;
+        }
+        // The rejected credit must not have used up one of the trust's three withdrawals
+        bool withdrawals_left = engine.try_transfer(trust, capped, 10.00) && engine.try_transfer(trust, capped, 10.00);
+        check(fits && !over_cap && over_cap.error() == Account_Error::illegal_balance
+              && !negative && negative.error() == Account_Error::negative_transfer && rejected && withdrawals_left
+              && engine.get_balance(capped) == Money{120.00} && engine.get_balance(trust) == Money{9'880.00},
+              "destination check_credit consulted, negative and zero-chunk requests rejected");
+    }
+
+    constexpr size_t account_count = 100'000;
+    mt19937_64 rng {25};
+    vector<unique_ptr<Account>> accounts;
+    for (size_t i = 0; i < account_count; i++)
+        accounts.push_back(std::move(make_account(static_cast<Account_Type>(i % 3), "Account " + to_string(i),
+                                                  1'000'000.00, 1.0).value()));
+    shuffle(accounts.begin(), accounts.end(), rng);         // popularity rank has nothing to do with address
+
+    // Zipf with s = 0.99: rank r is picked with probability proportional to 1 / r^s
+    vector<double> cdf(account_count);
+    double sum {0};
+    for (size_t r = 0; r < account_count; r++)
+        cdf[r] = sum += 1.0 / pow(static_cast<double>(r + 1), 0.99);
+    auto zipf = [&](mt19937_64 &gen) {
+        double u = uniform_real_distribution<double>{0.0, sum}(gen);
+        return static_cast<size_t>(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    };
+
+    cout << setw(8) << "threads" << setw(22) << "single (M/s)" << setw(22) << "batch of 16 (M/s)" << endl;
+    for (unsigned int threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        size_t per_thread = transfer_count / threads;
+        vector<vector<Transfer>> work(threads);
+        for (unsigned int t = 0; t < threads; t++) {
+            for (size_t i = 0; i < per_thread; i++) {
+                size_t from = zipf(rng);
+                size_t to = zipf(rng);
+                work[t].push_back(Transfer{accounts[from].get(), accounts[to].get(),
+                                           Money::from_cents(static_cast<long long>(rng() % 10'000))});
+            }
+        }
+        Transfer_Engine engine;
+        size_t succeeded {0};
+        auto start = chrono::steady_clock::now();
+        vector<size_t> counts(threads, 0);
+        run_threads(threads, [&](unsigned int t) {
+            for (const Transfer &transfer : work[t])
+                counts[t] += engine.try_transfer(*transfer.from, *transfer.to, transfer.amount).has_value();
+        });
+        double single_ms = ms_since(start);
+        start = chrono::steady_clock::now();
+        run_threads(threads, [&](unsigned int t) {
+            counts[t] += engine.transfer_all(work[t]).succeeded;
+        });
+        double batch_ms = ms_since(start);
+        for (size_t count : counts)
+            succeeded += count;
+        size_t total = per_thread * threads;
+        cout << setw(8) << threads << fixed << setprecision(2) << setw(22) << total / single_ms / 1000.0
+             << setw(22) << total / batch_ms / 1000.0 << "   (" << succeeded * 100 / (2 * total) << "% accepted)"
+             << endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    cout << "=== Batch deposits and withdrawals, 3M mixed accounts ===" << endl;
+    bench_ledger(3'000'000);
+    cout << "\n=== Monthly interest accrual, 3M mixed accounts ===" << endl;
+    bench_accrual(3'000'000);
+    cout << "\n=== Concurrent_Account stress ===" << endl;
+    stress_concurrent();
+    cout << "\n=== Contention: deposit/withdraw pairs on shared accounts ===" << endl;
+    bench_contention();
+    cout << "\n=== Dispatch: 10M mixed transactions on 1M accounts ===" << endl;
+    bench_dispatch(1'000'000, 10'000'000);
+    cout << "\n=== Rejection-heavy withdrawals, 1M on 10K accounts ===" << endl;
+    for (unsigned int overdraft_percent : {0u, 10u, 50u, 90u})
+        bench_rejections(10'000, 1'000'000, overdraft_percent);
+    // Journal size: 100M transactions (about 1.6 GiB of log) unless given on the command line
+    size_t journal_transactions = argc > 1 ? stoull(argv[1]) : 100'000'000;
+    cout << "\n=== Write-ahead journal, " << journal_transactions << " transactions ===" << endl;
+    bench_journal(journal_transactions);
+    cout << "\n=== Memory-mapped store, 50M accounts ===" << endl;
+    bench_store(50'000'000);
+    cout << "\n=== Sharded transaction processor, 100M transactions on 1M accounts ===" << endl;
+    bench_processor(100'000'000);
+    cout << "\n=== Printing 10M accounts ===" << endl;
+    bench_print(10'000'000);
+    cout << "\n=== Registry: 10M transactions routed by name, 1M accounts ===" << endl;
+    bench_registry(10'000'000);
+    cout << "\n=== Allocation: 10M polymorphic accounts ===" << endl;
+    bench_pool(10'000'000);
+    cout << "\n=== Incremental statements, 50M accounts, 0.1% daily activity ===" << endl;
+    bench_statements(50'000'000, 30);
+    cout << "\n=== Policy table: 20M transactions on 100K accounts ===" << endl;
+    bench_policies(20'000'000);
+    cout << "\n=== Transfers, 2M per thread count, Zipf popularity over 100K accounts ===" << endl;
+    bench_transfers(2'000'000);
+    return failures == 0 ? 0 : 1;
+}
@@ -1,22 +1,27 @@
 #include "Checking_Account.h"
 
-Checking_Account::Checking_Account(std::string name, double balance)
+Checking_Account::Checking_Account(std::string name, Money balance)
      : Account {name, balance} {
 }
 
 
-void Checking_Account::withdraw(double amount) {
-    amount += per_check_fee;
-    Account::withdraw(amount);
+// Adds the per-check fee. Checking has no withdrawal limit, so nothing is counted
+Expected<Money> Checking_Account::try_withdraw(Money amount) {
+    int withdrawals {0};
+    Expected<Money> result = rules.withdraw(balance, withdrawals, amount);
+    if (result)
+        balance = result.value();
+    return result;
 }
 
-bool Checking_Account::deposit(double amount) {
-    return Account::deposit(amount);
+Expected<Money> Checking_Account::try_deposit(Money amount) {
+    Expected<Money> result = rules.deposit(balance, amount, 0.0);
+    if (result)
+        balance = result.value();
+    return result;
 }
 
-void Checking_Account::print(std::ostream &os) const {
-    os.precision(2);
-    os << std::fixed;
-    os << "[Checking_Account: " << name << ": " << balance  << "]";
+void Checking_Account::format(Print_Buffer &buffer) const {
+    buffer.append("[Checking_Account: ").append(name).append(": ").append(balance).append(']');
 }
 
@@ -3,17 +3,22 @@
 #include <iostream>
 #include <string>
 #include "Account.h"
+#include "Account_Policy.h"
 
 class Checking_Account: public Account {
 private:
     static constexpr const char *def_name = "Unnamed Checking Account";
-    static constexpr double def_balance = 0.0;
-    static constexpr double per_check_fee = 0.0;
+    static constexpr Money def_balance = 0.0;
+    static constexpr Money per_check_fee = 0.0;
 public:
-    Checking_Account(std::string name = def_name, double balance = def_balance);    
-    virtual void withdraw(double) override;
-    virtual bool deposit(double) override;
-    virtual void print(std::ostream &os) const override;
+    // The rules above as a row of the policy table, compiled at compile time
+    static constexpr Account_Policy policy {"Checking", false, 0.0, 0.0, per_check_fee, 0, 0};
+    static constexpr Compiled_Policy rules {policy};
+
+    Checking_Account(std::string name = def_name, Money balance = def_balance);    
+    virtual Expected<Money> try_withdraw(Money) override;
+    virtual Expected<Money> try_deposit(Money) override;
+    virtual void format(Print_Buffer &buffer) const override;
 
     virtual ~Checking_Account() = default;
 };
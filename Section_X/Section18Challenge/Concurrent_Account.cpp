@@ -0,0 +1,69 @@
+#include "Concurrent_Account.h"
+
+Concurrent_Account::Concurrent_Account(Account_Type type, std::string name, Money balance, double int_rate)
+    : type {type}, name {name}, int_rate {int_rate}, state {0} {
+        if (balance < Money{} || balance.get_cents() > static_cast<long long>(balance_mask))
+            throw IllegalBalanceException();
+        state.store(static_cast<uint64_t>(balance.get_cents()), std::memory_order_relaxed);
+}
+
+bool Concurrent_Account::deposit(Money amount) {
+    // Deposited to a zero balance, the policy gives the amount with bonus and interest
+    Expected<Money> credited = rules_for(type).deposit(Money{}, amount, int_rate);
+    if (!credited || credited.value().get_cents() > static_cast<long long>(balance_mask))
+        return false;
+    uint64_t cents = static_cast<uint64_t>(credited.value().get_cents());
+
+    uint64_t current = state.load(std::memory_order_relaxed);
+    uint64_t updated;
+    do {
+        if ((current & balance_mask) + cents > balance_mask)
+            return false;
+        updated = current + cents;
+    } while (!state.compare_exchange_weak(current, updated, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+// The checks run against the value the CAS will replace, so a concurrent withdrawal can never slip in
+// between checking the trust rules (or the funds) and taking the money
+void Concurrent_Account::withdraw(Money amount) {
+    const Compiled_Policy &rules = rules_for(type);
+    Money charged = amount + rules.withdrawal_fee;
+    if (charged.get_cents() > static_cast<long long>(balance_mask))
+        throw InsufficientFundsException();
+    if (charged.get_cents() < -static_cast<long long>(balance_mask))
+        throw IllegalBalanceException();
+
+    uint64_t current = state.load(std::memory_order_relaxed);
+    uint64_t updated;
+    do {
+        Money balance = Money::from_cents(static_cast<long long>(current & balance_mask));
+        int count = static_cast<int>(current >> count_shift);
+        Expected<Money> result = rules.withdraw(balance, count, amount);
+        if (!result)
+            throw_account_error(result.error());
+        if (result.value().get_cents() > static_cast<long long>(balance_mask))
+            throw IllegalBalanceException();
+        updated = (static_cast<uint64_t>(count) << count_shift) | static_cast<uint64_t>(result.value().get_cents());
+    } while (!state.compare_exchange_weak(current, updated, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+void Concurrent_Account::format(Print_Buffer &buffer) const {
+    buffer.append("[Concurrent Account: ").append(name).append(": ").append(get_balance());
+    if (type != Account_Type::checking)
+        buffer.append(", ").append(int_rate).append('%');
+    if (type == Account_Type::trust)
+        buffer.append(", withdrawals: ").append(get_num_withdrawals());
+    buffer.append(']');
+}
+
+// getters
+Account_Type Concurrent_Account::get_type() const { return type; }
+std::string Concurrent_Account::get_name() const { return name; }
+double Concurrent_Account::get_int_rate() const { return int_rate; }
+Money Concurrent_Account::get_balance() const {
+    return Money::from_cents(static_cast<long long>(state.load(std::memory_order_acquire) & balance_mask));
+}
+int Concurrent_Account::get_num_withdrawals() const {
+    return static_cast<int>(state.load(std::memory_order_acquire) >> count_shift);
+}
@@ -0,0 +1,43 @@
+#ifndef _CONCURRENT_ACCOUNT_H_
+#define _CONCURRENT_ACCOUNT_H_
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "I_Printable.h"
+#include "Account_Ledger.h"
+
+// Thread-safe account
+// Any number of threads may deposit to and withdraw from the same account. The balance is kept in
+// whole cents together with the trust withdrawal count in one 64-bit word, and every transaction is a
+// compare-and-swap on that word - so the 3 withdrawal / 20% trust rule is checked against exactly the
+// balance the withdrawal is taken from. Follows the same rules as Checking_Account, Savings_Account and
+// Trust_Account.
+class Concurrent_Account : public I_Printable {
+private:
+    static constexpr const char *def_name = "Unnamed Concurrent Account";
+    static constexpr int count_shift = 56;                           // withdrawals live in the top 8 bits
+    static constexpr uint64_t balance_mask = (uint64_t{1} << count_shift) - 1;
+
+    const Account_Type type;
+    const std::string name;
+    const double int_rate;
+    alignas(64) std::atomic<uint64_t> state;       // own cache line, so neighbouring accounts don't contend
+public:
+    Concurrent_Account(Account_Type type, std::string name = def_name, Money balance = 0.0, double int_rate = 0.0);
+    Concurrent_Account(const Concurrent_Account &) = delete;
+    Concurrent_Account &operator=(const Concurrent_Account &) = delete;
+
+    bool deposit(Money amount);                    // false for a negative amount or a balance that would overflow
+    void withdraw(Money amount);                   // throws InsufficientFundsException / IllegalTrustWithdrawalException
+    virtual void format(Print_Buffer &buffer) const override;
+    virtual ~Concurrent_Account() = default;
+
+    Account_Type get_type() const;
+    std::string get_name() const;
+    double get_int_rate() const;
+    Money get_balance() const;
+    int get_num_withdrawals() const;
+};
+
+#endif // _CONCURRENT_ACCOUNT_H_
@@ -0,0 +1,16 @@
+#ifndef __DUPLICATE_ACCOUNT_EXCEPTION_H__
+#define __DUPLICATE_ACCOUNT_EXCEPTION_H__
+#include <exception>
+
+class DuplicateAccountException : public std::exception
+{
+public:
+    DuplicateAccountException() noexcept = default;
+    ~DuplicateAccountException() = default;
+
+    virtual const char *what() const noexcept override {
+        return "Duplicate account name";
+    }
+};
+
+#endif // __DUPLICATE_ACCOUNT_EXCEPTION_H__
@@ -0,0 +1,27 @@
+#ifndef _EXPECTED_H_
+#define _EXPECTED_H_
+#include <utility>
+#include <variant>
+#include "Account_Error.h"
+
+// Either a value or the Account_Error explaining why there is none (a small std::expected for C++17)
+// Rejections are ordinary return values, so a workload where most withdrawals bounce never unwinds.
+template <typename T>
+class Expected
+{
+private:
+    std::variant<T, Account_Error> result;
+public:
+    constexpr Expected(T value) : result {std::in_place_index<0>, std::move(value)} {}
+    constexpr Expected(Account_Error error) : result {std::in_place_index<1>, error} {}
+
+    constexpr bool has_value() const { return result.index() == 0; }
+    constexpr explicit operator bool() const { return has_value(); }
+
+    // Only valid when has_value() / !has_value()
+    constexpr T &value() { return *std::get_if<0>(&result); }
+    constexpr const T &value() const { return *std::get_if<0>(&result); }
+    constexpr Account_Error error() const { return *std::get_if<1>(&result); }
+};
+
+#endif // _EXPECTED_H_
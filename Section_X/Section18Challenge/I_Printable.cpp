@@ -6,3 +6,11 @@ std::ostream &operator<<(std::ostream &os, const I_Printable &obj) {
     return os;
 }
 
+void I_Printable::print(std::ostream &os) const {
+    thread_local Print_Buffer buffer;
+    os.precision(2);
+    os << std::fixed;
+    buffer.clear();
+    format(buffer);
+    buffer.write_to(os);
+}
@@ -1,12 +1,16 @@
 #ifndef _I_PRINTABLE_H_
 #define _I_PRINTABLE_H_
 #include <iostream>
+#include "Print_Buffer.h"
 
 class I_Printable
 {
     friend std::ostream &operator<<(std::ostream &os, const I_Printable &obj);
 public:
-    virtual void print(std::ostream &os) const = 0;
+    // Formats through format() and writes the text in one go; leaves os in std::fixed with
+    // precision 2, as the stream printers always did
+    virtual void print(std::ostream &os) const;
+    virtual void format(Print_Buffer &buffer) const = 0;
     virtual ~I_Printable() = default;
 
 };
@@ -0,0 +1,16 @@
+#ifndef __JOURNAL_IO_EXCEPTION_H__
+#define __JOURNAL_IO_EXCEPTION_H__
+#include <exception>
+
+class JournalIOException : public std::exception
+{
+public:
+    JournalIOException() noexcept = default;
+    ~JournalIOException() = default;
+
+    virtual const char *what() const noexcept override {
+        return "Journal I/O Exception";
+    }
+};
+
+#endif // __JOURNAL_IO_EXCEPTION_H__
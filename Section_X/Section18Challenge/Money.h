@@ -0,0 +1,92 @@
+#ifndef _MONEY_H_
+#define _MONEY_H_
+#include <iostream>
+#include <limits>
+#include <string>
+#include "MoneyOverflowException.h"
+
+// Fixed-point amount of money: a whole number of cents in a 64-bit integer
+// Adding, subtracting and comparing amounts is exact integer math; anything that would leave the
+// range of long long throws MoneyOverflowException instead of wrapping. Everything is constexpr, so
+// amounts like Trust_Account's bonus threshold are checked and converted at compile time.
+class Money
+{
+    friend std::ostream &operator<<(std::ostream &os, const Money &money);
+private:
+    static constexpr long long max_cents = std::numeric_limits<long long>::max();
+    static constexpr long long min_cents = std::numeric_limits<long long>::min();
+
+    long long cents;
+public:
+    constexpr Money() : cents {0} {}
+    constexpr Money(double amount) : cents {nearest_cents(amount * 100.0)} {}    // implicit: Money m = 12.34;
+    static constexpr Money from_cents(long long cents) {
+        Money money;
+        money.cents = cents;
+        return money;
+    }
+
+    // Rounds a number of cents to the nearest whole cent, ties to even - the same rule as std::nearbyint
+    // and as print() with precision 2
+    static constexpr long long nearest_cents(double cents) {
+        if (!(cents > -9.2e18 && cents < 9.2e18))          // also rejects NaN
+            throw MoneyOverflowException();
+        long long whole = static_cast<long long>(cents);   // toward zero
+        double rest = cents - static_cast<double>(whole);   // exact
+        if (rest > 0.5 || (rest == 0.5 && (whole & 1)))
+            whole++;
+        else if (rest < -0.5 || (rest == -0.5 && (whole & 1)))
+            whole--;
+        return whole;
+    }
+
+    constexpr long long get_cents() const { return cents; }
+    constexpr double to_double() const { return cents / 100.0; }
+
+    // This amount times factor, rounded to the nearest cent (interest, bonuses)
+    constexpr Money scaled(double factor) const { return from_cents(nearest_cents(cents * factor)); }
+
+    constexpr Money operator+(Money rhs) const {
+        if ((rhs.cents > 0 && cents > max_cents - rhs.cents) || (rhs.cents < 0 && cents < min_cents - rhs.cents))
+            throw MoneyOverflowException();
+        return from_cents(cents + rhs.cents);
+    }
+    constexpr Money operator-(Money rhs) const {
+        if ((rhs.cents < 0 && cents > max_cents + rhs.cents) || (rhs.cents > 0 && cents < min_cents + rhs.cents))
+            throw MoneyOverflowException();
+        return from_cents(cents - rhs.cents);
+    }
+    constexpr Money operator-() const {
+        if (cents == min_cents)
+            throw MoneyOverflowException();
+        return from_cents(-cents);
+    }
+    constexpr Money operator*(long long factor) const {
+        if (cents > 0 ? (factor > 0 ? cents > max_cents / factor : factor < min_cents / cents)
+                      : (factor > 0 ? cents < min_cents / factor : (cents != 0 && factor < max_cents / cents)))
+            throw MoneyOverflowException();
+        return from_cents(cents * factor);
+    }
+    constexpr Money &operator+=(Money rhs) { return *this = *this + rhs; }
+    constexpr Money &operator-=(Money rhs) { return *this = *this - rhs; }
+
+    constexpr bool operator==(Money rhs) const { return cents == rhs.cents; }
+    constexpr bool operator!=(Money rhs) const { return cents != rhs.cents; }
+    constexpr bool operator<(Money rhs) const { return cents < rhs.cents; }
+    constexpr bool operator<=(Money rhs) const { return cents <= rhs.cents; }
+    constexpr bool operator>(Money rhs) const { return cents > rhs.cents; }
+    constexpr bool operator>=(Money rhs) const { return cents >= rhs.cents; }
+};
+
+// Always exact, as [-]dollars.cents - the stream's precision and fixed flags are not needed
+inline std::ostream &operator<<(std::ostream &os, const Money &money) {
+    unsigned long long magnitude = money.cents < 0 ? 0ULL - static_cast<unsigned long long>(money.cents)
+                                                   : static_cast<unsigned long long>(money.cents);
+    unsigned long long fraction = magnitude % 100;
+    std::string text = (money.cents < 0 ? "-" : "") + std::to_string(magnitude / 100) + '.'
+                     + static_cast<char>('0' + fraction / 10) + static_cast<char>('0' + fraction % 10);
+    os << text;
+    return os;
+}
+
+#endif // _MONEY_H_
@@ -0,0 +1,16 @@
+#ifndef __MONEY_OVERFLOW_EXCEPTION_H__
+#define __MONEY_OVERFLOW_EXCEPTION_H__
+#include <exception>
+
+class MoneyOverflowException : public std::exception
+{
+public:
+    MoneyOverflowException() noexcept = default;
+    ~MoneyOverflowException() = default;
+
+    virtual const char *what() const noexcept override {
+        return "Money Overflow Exception";
+    }
+};
+
+#endif // __MONEY_OVERFLOW_EXCEPTION_H__
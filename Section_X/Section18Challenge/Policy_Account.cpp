@@ -0,0 +1,36 @@
+#include "Policy_Account.h"
+
+Policy_Account::Policy_Account(const Compiled_Policy &rules, std::string name, Money balance, double int_rate)
+    : Account {name, balance}, rules {&rules}, int_rate {int_rate}, num_withdrawals {0} {
+}
+
+Expected<Money> Policy_Account::try_deposit(Money amount) {
+    Expected<Money> result = rules->deposit(balance, amount, int_rate);
+    if (result)
+        balance = result.value();
+    return result;
+}
+
+Expected<Money> Policy_Account::try_withdraw(Money amount) {
+    Expected<Money> result = rules->withdraw(balance, num_withdrawals, amount);
+    if (result)
+        balance = result.value();
+    return result;
+}
+
+void Policy_Account::format(Print_Buffer &buffer) const {
+    buffer.append('[').append(rules->get_product()).append(" Account: ").append(name).append(": ").append(balance)
+        .append(", ").append(int_rate).append("%, withdrawals: ").append(num_withdrawals).append(']');
+}
+
+const Compiled_Policy &Policy_Account::get_rules() const { return *rules; }
+
+int Policy_Account::get_num_withdrawals() const { return num_withdrawals; }
+
+std::vector<Compiled_Policy> compile_policies(const std::vector<Account_Policy> &table) {
+    std::vector<Compiled_Policy> compiled;
+    compiled.reserve(table.size());
+    for (const Account_Policy &policy : table)
+        compiled.emplace_back(policy);
+    return compiled;
+}
@@ -0,0 +1,36 @@
+#ifndef _POLICY_ACCOUNT_H_
+#define _POLICY_ACCOUNT_H_
+#include <string>
+#include <vector>
+#include "Account.h"
+#include "Account_Policy.h"
+
+// An account whose rules come from a compiled policy table row
+// One class serves every product variant: the account points at its Compiled_Policy, which has to
+// outlive it. With Checking_Account::policy, Savings_Account::policy or Trust_Account::policy it
+// behaves exactly like that class.
+class Policy_Account: public Account {
+private:
+    static constexpr const char *def_name = "Unnamed Policy Account";
+    static constexpr Money def_balance = 0.0;
+    static constexpr double def_int_rate = 0.0;
+
+    const Compiled_Policy *rules;
+    double int_rate;
+    int num_withdrawals;
+public:
+    Policy_Account(const Compiled_Policy &rules, std::string name = def_name, Money balance = def_balance,
+                   double int_rate = def_int_rate);
+    virtual Expected<Money> try_deposit(Money amount) override;
+    virtual Expected<Money> try_withdraw(Money amount) override;
+    virtual void format(Print_Buffer &buffer) const override;
+    virtual ~Policy_Account() = default;
+
+    const Compiled_Policy &get_rules() const;
+    int get_num_withdrawals() const;
+};
+
+// Compiles a policy table once; accounts then point into the result, so it must not be resized
+std::vector<Compiled_Policy> compile_policies(const std::vector<Account_Policy> &table);
+
+#endif // _POLICY_ACCOUNT_H_
@@ -0,0 +1,28 @@
+#include "Print_Buffer.h"
+
+Print_Buffer::Print_Buffer(size_t capacity)
+    : data {std::make_unique<char[]>(capacity)}, length {0}, capacity {capacity} {
+}
+
+void Print_Buffer::grow(size_t needed) {
+    size_t new_capacity = capacity * 2;
+    if (new_capacity < length + needed)
+        new_capacity = length + needed;
+    std::unique_ptr<char[]> bigger = std::make_unique<char[]>(new_capacity);
+    std::memcpy(bigger.get(), data.get(), length);
+    data = std::move(bigger);
+    capacity = new_capacity;
+}
+
+// A double needs at most 309 integer digits, the sign, the point and 2 decimals
+Print_Buffer &Print_Buffer::append(double number) {
+    constexpr size_t max_length = 320;
+    char *first = reserve(max_length);
+    length = std::to_chars(first, first + max_length, number, std::chars_format::fixed, 2).ptr - data.get();
+    return *this;
+}
+
+void Print_Buffer::write_to(std::ostream &os) {
+    os.write(data.get(), static_cast<std::streamsize>(length));
+    length = 0;
+}
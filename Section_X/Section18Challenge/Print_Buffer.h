@@ -0,0 +1,75 @@
+#ifndef _PRINT_BUFFER_H_
+#define _PRINT_BUFFER_H_
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include "Money.h"
+
+// Reusable output buffer for printing accounts
+// Text is appended with std::to_chars (no locale, no stream state, no allocation once the buffer has
+// grown to its working size) and reaches the stream with one write. Doubles come out as the stream
+// prints them with std::fixed and precision 2, and Money exactly as its operator<<, so the text is the
+// same as the stream version byte for byte.
+class Print_Buffer
+{
+private:
+    std::unique_ptr<char[]> data;
+    size_t length;
+    size_t capacity;
+
+    void grow(size_t needed);
+    char *reserve(size_t needed) {              // room for needed more characters
+        if (capacity - length < needed)
+            grow(needed);
+        return data.get() + length;
+    }
+public:
+    static constexpr size_t batch_size = 1 << 20;         // batch printers write out once past this
+
+    explicit Print_Buffer(size_t capacity = 4096);
+    Print_Buffer(const Print_Buffer &) = delete;
+    Print_Buffer &operator=(const Print_Buffer &) = delete;
+
+    Print_Buffer &append(std::string_view text) {
+        std::memcpy(reserve(text.size()), text.data(), text.size());
+        length += text.size();
+        return *this;
+    }
+    Print_Buffer &append(char c) {
+        *reserve(1) = c;
+        length++;
+        return *this;
+    }
+    Print_Buffer &append(long long number) {
+        char *first = reserve(20);
+        length = std::to_chars(first, first + 20, number).ptr - data.get();
+        return *this;
+    }
+    Print_Buffer &append(int number) { return append(static_cast<long long>(number)); }
+    Print_Buffer &append(Money amount) {
+        long long cents = amount.get_cents();
+        unsigned long long magnitude = cents < 0 ? 0ULL - static_cast<unsigned long long>(cents)
+                                                 : static_cast<unsigned long long>(cents);
+        char *first = reserve(24);
+        char *last = first;
+        if (cents < 0)
+            *last++ = '-';
+        last = std::to_chars(last, first + 24, magnitude / 100).ptr;
+        *last++ = '.';
+        *last++ = static_cast<char>('0' + magnitude % 100 / 10);
+        *last++ = static_cast<char>('0' + magnitude % 10);
+        length = last - data.get();
+        return *this;
+    }
+    Print_Buffer &append(double number);        // fixed, 2 decimals
+
+    const char *get_data() const { return data.get(); }
+    size_t size() const { return length; }
+    void clear() { length = 0; }
+    void write_to(std::ostream &os);            // one write, then empty again
+};
+
+#endif // _PRINT_BUFFER_H_
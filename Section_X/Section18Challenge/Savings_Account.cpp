@@ -1,25 +1,39 @@
 #include "Savings_Account.h"
 
-Savings_Account::Savings_Account(std::string name, double balance, double int_rate)
+Savings_Account::Savings_Account(std::string name, Money balance, double int_rate)
      : Account {name, balance}, int_rate{int_rate} {
 }
 
 // Deposit:
 //      Amount supplied to deposit will be incremented by (amount * int_rate/100) 
-//      and then the updated amount will be deposited
+//      (rounded to the nearest cent) and then the updated amount will be deposited
 //
-bool Savings_Account::deposit(double amount) {
-    amount += amount * (int_rate/100);
-    return Account::deposit(amount);
+Expected<Money> Savings_Account::try_deposit(Money amount) {
+    Expected<Money> result = rules.deposit(balance, amount, int_rate);
+    if (result)
+        balance = result.value();
+    return result;
 }
 
-void Savings_Account::withdraw(double amount) {
-    Account::withdraw(amount);
+// No fee and no limit, so nothing is counted
+Expected<Money> Savings_Account::try_withdraw(Money amount) {
+    int withdrawals {0};
+    Expected<Money> result = rules.withdraw(balance, withdrawals, amount);
+    if (result)
+        balance = result.value();
+    return result;
+}
+
+// Account_Ledger::accrue_interest evaluates exactly this expression, so both give the same balances
+Money Savings_Account::accrue_interest(int periods_per_year) {
+    Money updated = balance.scaled(1.0 + (int_rate/100.0)/periods_per_year);
+    Money interest = updated - balance;
+    balance = updated;
+    return interest;
 }
 
 
-void Savings_Account::print(std::ostream &os) const {
-    os.precision(2);
-    os << std::fixed;
-    os << "[Savings_Account: " << name << ": " << balance << ", " << int_rate << "]";
+void Savings_Account::format(Print_Buffer &buffer) const {
+    buffer.append("[Savings_Account: ").append(name).append(": ").append(balance).append(", ").append(int_rate)
+        .append(']');
 }
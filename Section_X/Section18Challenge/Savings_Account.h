@@ -1,19 +1,29 @@
 #ifndef _SAVINGS_ACCOUNT_H_
 #define _SAVINGS_ACCOUNT_H_
 #include "Account.h"
+#include "Account_Policy.h"
 
 class Savings_Account: public Account {
 private:
     static constexpr const char *def_name = "Unnamed Savings Account";
-    static constexpr double def_balance = 0.0;
+    static constexpr Money def_balance = 0.0;
     static constexpr double def_int_rate = 0.0;
 protected:
     double int_rate;
 public:
-    Savings_Account(std::string name = def_name, double balance =def_balance, double int_rate = def_int_rate);    
-    virtual bool deposit(double amount) override;
-    virtual void withdraw(double amount) override;
-    virtual void print(std::ostream &os) const override;
+    // Savings rules as a row of the policy table, compiled at compile time
+    static constexpr Account_Policy policy {"Savings", true, 0.0, 0.0, 0.0, 0, 0};
+    static constexpr Compiled_Policy rules {policy};
+
+    Savings_Account(std::string name = def_name, Money balance =def_balance, double int_rate = def_int_rate);    
+    virtual Expected<Money> try_deposit(Money amount) override;
+    virtual Expected<Money> try_withdraw(Money amount) override;
+    virtual void format(Print_Buffer &buffer) const override;
+
+    // Interest:
+    //      Compounds one period - the balance grows by int_rate/periods_per_year percent and is rounded
+    //      to whole cents. Returns the interest credited.
+    Money accrue_interest(int periods_per_year = 12);
 
     virtual ~Savings_Account() = default;
 };
@@ -0,0 +1,81 @@
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread
+// The producer only writes tail and the consumer only writes head, each on its own cache line, and
+// each side keeps a private copy of the other's index so it reads the shared one only when the ring
+// looks full (or empty). Capacity is rounded up to a power of two.
+template <typename T>
+class Spsc_Ring
+{
+private:
+    alignas(64) std::atomic<size_t> head;      // next slot to read - written by the consumer
+    size_t cached_tail;                        // consumer's copy of tail
+    alignas(64) std::atomic<size_t> tail;      // next slot to write - written by the producer
+    size_t cached_head;                        // producer's copy of head
+    alignas(64) std::vector<T> slots;
+    size_t mask;
+
+    static size_t round_up(size_t capacity) {
+        size_t size {2};
+        while (size < capacity)
+            size *= 2;
+        return size;
+    }
+public:
+    explicit Spsc_Ring(size_t capacity)
+        : head {0}, cached_tail {0}, tail {0}, cached_head {0}, slots(round_up(capacity)), mask {slots.size() - 1} {
+    }
+    Spsc_Ring(const Spsc_Ring &) = delete;
+    Spsc_Ring &operator=(const Spsc_Ring &) = delete;
+
+    // Producer side: false when the ring is full
+    bool try_push(const T &value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head == slots.size())
+                return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: false when the ring is empty
+    bool try_pop(T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h == cached_tail)
+                return false;
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: hands every item available right now (up to max) to consume, then frees all
+    // their slots with one store. Returns how many there were.
+    template <typename Function>
+    size_t consume_all(Function &&consume, size_t max = static_cast<size_t>(-1)) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h == cached_tail)
+                return 0;
+        }
+        size_t available = cached_tail - h < max ? cached_tail - h : max;
+        for (size_t i = 0; i < available; i++)
+            consume(slots[(h + i) & mask]);
+        head.store(h + available, std::memory_order_release);
+        return available;
+    }
+
+    size_t capacity() const { return slots.size(); }
+};
+
+#endif // _SPSC_RING_H_
@@ -0,0 +1,16 @@
+#ifndef __STORE_IO_EXCEPTION_H__
+#define __STORE_IO_EXCEPTION_H__
+#include <exception>
+
+class StoreIOException : public std::exception
+{
+public:
+    StoreIOException() noexcept = default;
+    ~StoreIOException() = default;
+
+    virtual const char *what() const noexcept override {
+        return "Store I/O Exception";
+    }
+};
+
+#endif // __STORE_IO_EXCEPTION_H__
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <thread>
+#include "Transaction_Processor.h"
+
+Transaction_Processor::Transaction_Processor(Account_Ledger &ledger, unsigned int threads, size_t ring_capacity)
+    : ledger {ledger}, threads {threads} {
+        if (this->threads == 0)
+            this->threads = std::thread::hardware_concurrency();
+        if (this->threads == 0)
+            this->threads = 1;
+        for (unsigned int i = 0; i < this->threads * this->threads; i++)
+            rings.push_back(std::make_unique<Spsc_Ring<Transaction>>(ring_capacity));
+}
+
+// Nothing may escape a worker thread (that would be std::terminate), and a worker that stopped would
+// leave the others blocked on its full rings. A transaction whose balance would overflow leaves the
+// balance unchanged and is counted like any other rejection; an overflowing total is kept for
+// process() to rethrow once every worker is done.
+void Transaction_Processor::apply(const Transaction &transaction, Worker_State &state) {
+    Processor_Report &report = state.report;
+    bool deposit = transaction.kind == Transaction_Kind::deposit;
+    Expected<Money> result {Account_Error::negative_deposit};
+    try {
+        if (deposit)
+            result = ledger.try_deposit(transaction.id, transaction.amount, state.ceiling, state.changed);
+        else
+            result = ledger.try_withdraw(transaction.id, transaction.amount, state.ceiling, state.changed);
+    }
+    catch (const MoneyOverflowException &) {
+        report.overflows++;
+        return;
+    }
+    if (!result) {
+        if (deposit)
+            report.rejected_deposits++;
+        else if (result.error() == Account_Error::insufficient_funds)
+            report.insufficient_funds++;
+        else
+            report.illegal_trust_withdrawals++;
+        return;
+    }
+    (deposit ? report.deposits : report.withdrawals)++;
+    try {
+        (deposit ? report.deposited : report.withdrawn) += transaction.amount;
+    }
+    catch (const MoneyOverflowException &) {
+        if (!state.error)
+            state.error = std::current_exception();
+    }
+}
+
+// One worker: producer for its slice of the input, consumer for its shard of the accounts
+void Transaction_Processor::work(unsigned int worker, const Transaction *begin, const Transaction *end,
+                                 size_t shard_size, std::atomic<unsigned int> &producers_done,
+                                 Worker_State &state) {
+    constexpr size_t route_batch = 256;
+    size_t account_count = ledger.size();
+    auto apply_here = [&](const Transaction &transaction) { apply(transaction, state); };
+    auto drain = [&]() {
+        size_t applied {0};
+        for (unsigned int producer = 0; producer < threads; producer++)
+            applied += rings[producer * threads + worker]->consume_all(apply_here);
+        return applied;
+    };
+
+    const Transaction *next = begin;
+    bool produced = false;
+    while (true) {
+        bool blocked = false;
+        for (size_t i = 0; i < route_batch && next != end; i++, next++) {
+            if (next->id >= account_count) {
+                state.report.unknown_accounts++;
+                continue;
+            }
+            unsigned int shard = static_cast<unsigned int>(next->id / shard_size);
+            if (shard == worker)
+                apply(*next, state);                            // own account: no need to queue it
+            else if (!rings[worker * threads + shard]->try_push(*next)) {
+                blocked = true;                                 // full: drain our own rings, then retry
+                break;
+            }
+        }
+        if (next == end && !produced) {
+            produced = true;
+            producers_done.fetch_add(1, std::memory_order_release);
+        }
+        size_t applied = drain();
+        if (blocked && applied == 0)
+            std::this_thread::yield();                          // let the shard's owner catch up
+        if (produced && applied == 0) {
+            // Once every producer is done nothing new can arrive, so one more pass empties our rings
+            if (producers_done.load(std::memory_order_acquire) == threads) {
+                drain();
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+Processor_Report Transaction_Processor::process(const std::vector<Transaction> &transactions) {
+    auto start = std::chrono::steady_clock::now();
+    size_t account_count = ledger.size();
+    size_t shard_size = account_count / threads + 1;
+    size_t count = transactions.size();
+
+    std::vector<Worker_State> states(threads, Worker_State{Processor_Report{}, ledger.balance_ceiling, {}, nullptr});
+    std::atomic<unsigned int> producers_done {0};
+    auto run = [&](unsigned int worker) {
+        const Transaction *data = transactions.data();
+        work(worker, data + count * worker / threads, data + count * (worker + 1) / threads, shard_size,
+             producers_done, states[worker]);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int worker = 1; worker < threads; worker++)
+        workers.emplace_back(run, worker);
+    run(0);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    // The ledger's own bookkeeping first, so it is complete even if a total overflows below
+    std::vector<size_t> &changed = ledger.epoch_changes.back();
+    for (unsigned int worker = 0; worker < threads; worker++) {
+        if (states[worker].ceiling > ledger.balance_ceiling)
+            ledger.balance_ceiling = states[worker].ceiling;
+        changed.insert(changed.end(), states[worker].changed.begin(), states[worker].changed.end());
+    }
+    for (unsigned int worker = 0; worker < threads; worker++)
+        if (states[worker].error)
+            std::rethrow_exception(states[worker].error);
+
+    Processor_Report total {};
+    for (unsigned int worker = 0; worker < threads; worker++) {
+        const Processor_Report &report = states[worker].report;
+        total.deposits += report.deposits;
+        total.withdrawals += report.withdrawals;
+        total.rejected_deposits += report.rejected_deposits;
+        total.insufficient_funds += report.insufficient_funds;
+        total.illegal_trust_withdrawals += report.illegal_trust_withdrawals;
+        total.overflows += report.overflows;
+        total.unknown_accounts += report.unknown_accounts;
+        total.deposited += report.deposited;
+        total.withdrawn += report.withdrawn;
+    }
+    total.threads = threads;
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    total.transactions_per_second = total.seconds > 0 ? count / total.seconds : 0.0;
+    return total;
+}
+
+unsigned int Transaction_Processor::get_threads() const { return threads; }
@@ -0,0 +1,78 @@
+#ifndef _TRANSACTION_PROCESSOR_H_
+#define _TRANSACTION_PROCESSOR_H_
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <vector>
+#include "Account_Ledger.h"
+#include "Spsc_Ring.h"
+
+enum class Transaction_Kind : unsigned char {
+    deposit,
+    withdraw
+};
+
+struct Transaction {
+    size_t id;
+    Money amount;
+    Transaction_Kind kind;
+};
+
+// Totals for one process() call - the batch replacement for a console line per transaction
+struct Processor_Report {
+    size_t deposits;                   // applied
+    size_t withdrawals;
+    size_t rejected_deposits;          // negative amounts
+    size_t insufficient_funds;
+    size_t illegal_trust_withdrawals;
+    size_t overflows;                  // would have overflowed a balance (MoneyOverflowException); balance left as it was
+    size_t unknown_accounts;           // ids past the end of the ledger, skipped
+    Money deposited;                   // amounts as submitted, before interest and bonuses
+    Money withdrawn;
+    unsigned int threads;
+    double seconds;
+    double transactions_per_second;
+};
+
+// Parallel transaction engine over an Account_Ledger
+// The accounts are split into one contiguous id range (shard) per worker thread, and only the owner
+// of a shard ever touches its accounts, so the ledger needs no locks. The input is split the same
+// way into one slice per worker: each worker routes its slice to the owning shards through
+// single-producer/single-consumer rings (one ring per producer/shard pair), and in between drains the
+// rings addressed to its own shard. A worker that finds a ring full drains its own rings before
+// retrying, so the exchange cannot deadlock.
+//
+// Transactions on one account are applied in input order when they come from the same slice; ones
+// from different slices interleave like requests from separate clients would. With threads = 1 the
+// result is exactly the serial result. Nothing else may use the ledger while process() runs.
+// process() throws MoneyOverflowException only when a report total overflows, after every
+// transaction has been applied.
+class Transaction_Processor
+{
+private:
+    // What one worker changes besides its own accounts, merged into the ledger at the end
+    // (own cache line, so workers don't contend on their counters)
+    struct alignas(64) Worker_State {
+        Processor_Report report;
+        long long ceiling;
+        std::vector<size_t> changed;      // for the ledger's change tracking
+        std::exception_ptr error;         // first overflow of a report total, rethrown by process()
+    };
+
+    Account_Ledger &ledger;
+    unsigned int threads;
+    std::vector<std::unique_ptr<Spsc_Ring<Transaction>>> rings;    // rings[producer * threads + shard]
+
+    void work(unsigned int worker, const Transaction *begin, const Transaction *end, size_t shard_size,
+              std::atomic<unsigned int> &producers_done, Worker_State &state);
+    void apply(const Transaction &transaction, Worker_State &state);
+public:
+    explicit Transaction_Processor(Account_Ledger &ledger, unsigned int threads = 0, size_t ring_capacity = 16384);
+
+    Processor_Report process(const std::vector<Transaction> &transactions);
+
+    unsigned int get_threads() const;
+};
+
+#endif // _TRANSACTION_PROCESSOR_H_
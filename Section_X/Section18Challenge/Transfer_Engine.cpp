@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <stdexcept>
+#include "Transfer_Engine.h"
+
+// stripe_of shifts by 64 - stripe_bits, which needs at least one bit; 2^20 stripes is already 64 MiB
+static unsigned int checked_stripe_bits(unsigned int stripe_bits) {
+    if (stripe_bits < 1 || stripe_bits > Transfer_Engine::max_stripe_bits)
+        throw std::invalid_argument("Transfer_Engine: stripe_bits must be 1 to 20");
+    return stripe_bits;
+}
+
+Transfer_Engine::Transfer_Engine(unsigned int stripe_bits)
+    : stripes {std::make_unique<Stripe[]>(size_t{1} << checked_stripe_bits(stripe_bits))}, stripe_bits {stripe_bits} {
+}
+
+// The destination's check_credit runs first and changes nothing, so a rejection or an overflow there
+// leaves both accounts as they were; the withdrawal can then be rejected or overflow itself, and the
+// checked credit is only stored once it has gone through
+Expected<Money> Transfer_Engine::apply(Account &from, Account &to, Money amount) {
+    if (amount < Money{})
+        return Account_Error::negative_transfer;
+    if (&from == &to)
+        return from.balance;
+    Expected<Money> credited = to.check_credit(amount);
+    if (!credited)
+        return credited.error();
+    Expected<Money> result = from.try_withdraw(amount);
+    if (result)
+        to.balance = credited.value();
+    return result;
+}
+
+Expected<Money> Transfer_Engine::try_transfer(Account &from, Account &to, Money amount) {
+    size_t first = stripe_of(&from);
+    size_t second = stripe_of(&to);
+    if (first > second)
+        std::swap(first, second);
+    std::lock_guard<std::mutex> first_lock {stripes[first].mutex};
+    if (first == second)
+        return apply(from, to, amount);
+    std::lock_guard<std::mutex> second_lock {stripes[second].mutex};
+    return apply(from, to, amount);
+}
+
+void Transfer_Engine::transfer(Account &from, Account &to, Money amount) {
+    Expected<Money> result = try_transfer(from, to, amount);
+    if (!result)
+        throw_account_error(result.error());
+}
+
+Batch_Result Transfer_Engine::transfer_all(const std::vector<Transfer> &transfers, size_t chunk_size) {
+    if (chunk_size == 0)
+        throw std::invalid_argument("Transfer_Engine: chunk_size must be at least 1");
+    // Unlocks whatever was locked, also when a transfer throws
+    struct Held {
+        Stripe *stripes;
+        const std::vector<size_t> &order;
+        size_t count;
+        ~Held() {
+            while (count > 0)
+                stripes[order[--count]].mutex.unlock();
+        }
+    };
+
+    size_t succeeded {0};
+    std::vector<size_t> needed;
+    needed.reserve(2 * chunk_size);
+    for (size_t begin = 0; begin < transfers.size(); begin += chunk_size) {
+        size_t end = std::min(begin + chunk_size, transfers.size());
+        needed.clear();
+        for (size_t i = begin; i < end; i++) {
+            needed.push_back(stripe_of(transfers[i].from));
+            needed.push_back(stripe_of(transfers[i].to));
+        }
+        std::sort(needed.begin(), needed.end());
+        needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+
+        Held held {stripes.get(), needed, 0};
+        for (size_t stripe : needed) {
+            stripes[stripe].mutex.lock();
+            held.count++;
+        }
+        for (size_t i = begin; i < end; i++)
+            succeeded += apply(*transfers[i].from, *transfers[i].to, transfers[i].amount).has_value();
+    }
+    return Batch_Result{succeeded, transfers.size() - succeeded};
+}
+
+Expected<Money> Transfer_Engine::try_deposit(Account &account, Money amount) {
+    std::lock_guard<std::mutex> lock {stripes[stripe_of(&account)].mutex};
+    return account.try_deposit(amount);
+}
+
+Expected<Money> Transfer_Engine::try_withdraw(Account &account, Money amount) {
+    std::lock_guard<std::mutex> lock {stripes[stripe_of(&account)].mutex};
+    return account.try_withdraw(amount);
+}
+
+Money Transfer_Engine::get_balance(const Account &account) {
+    std::lock_guard<std::mutex> lock {stripes[stripe_of(&account)].mutex};
+    return account.balance;
+}
@@ -0,0 +1,68 @@
+#ifndef _TRANSFER_ENGINE_H_
+#define _TRANSFER_ENGINE_H_
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Account.h"
+#include "Account_Ledger.h"
+
+struct Transfer {
+    Account *from;
+    Account *to;
+    Money amount;
+};
+
+// Atomic transfers between any two Account objects, from any number of threads
+// Accounts are guarded by a table of striped mutexes, picked by hashing the account's address. A
+// transfer locks the stripes of both accounts in stripe order - every thread takes locks in the same
+// global order, so no set of transfers can deadlock. The source is debited through its own
+// try_withdraw, so Checking_Account fees and the Trust_Account withdrawal count and 20% rule apply;
+// the destination is credited the plain amount, without the interest and Trust_Account bonus a
+// deposit would add - moving money between accounts must not create any - after its check_credit
+// has approved it. The credit is only stored once the withdrawal has gone through, all before the
+// locks are released, so other threads only ever see both halves or neither. Every access to an
+// account shared this way must go through the engine.
+class Transfer_Engine
+{
+private:
+    struct alignas(64) Stripe {        // own cache line, so neighbouring stripes don't contend
+        std::mutex mutex;
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    unsigned int stripe_bits;
+
+    size_t stripe_of(const Account *account) const {
+        uint64_t address = reinterpret_cast<uintptr_t>(account);
+        return static_cast<size_t>((address >> 4) * 0x9E3779B97F4A7C15ULL >> (64 - stripe_bits));
+    }
+    Expected<Money> apply(Account &from, Account &to, Money amount);   // with both stripes held
+public:
+    static constexpr unsigned int max_stripe_bits = 20;
+
+    // 2^stripe_bits stripes; std::invalid_argument unless stripe_bits is 1 to max_stripe_bits
+    explicit Transfer_Engine(unsigned int stripe_bits = 12);
+    Transfer_Engine(const Transfer_Engine &) = delete;
+    Transfer_Engine &operator=(const Transfer_Engine &) = delete;
+
+    // Returns the source's new balance, or why the transfer was rejected: negative_transfer for a
+    // negative amount, whatever the destination's check_credit rejects it with, or the source's
+    // insufficient_funds / illegal_trust_withdrawal. A transfer to the same account changes nothing
+    // and returns its balance.
+    Expected<Money> try_transfer(Account &from, Account &to, Money amount);
+    void transfer(Account &from, Account &to, Money amount);          // throws like Account::withdraw
+
+    // Applies the transfers in order, locking the stripes of chunk_size transfers at a time (again in
+    // stripe order), so popular accounts are locked once per chunk instead of once per transfer;
+    // std::invalid_argument for a chunk_size of 0
+    Batch_Result transfer_all(const std::vector<Transfer> &transfers, size_t chunk_size = 16);
+
+    // Single-account transactions and reads under the same locks
+    Expected<Money> try_deposit(Account &account, Money amount);
+    Expected<Money> try_withdraw(Account &account, Money amount);
+    Money get_balance(const Account &account);
+};
+
+#endif // _TRANSFER_ENGINE_H_
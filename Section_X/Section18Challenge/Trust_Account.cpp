@@ -1,31 +1,29 @@
 #include "Trust_Account.h"
 
-Trust_Account::Trust_Account(std::string name, double balance, double int_rate)
+Trust_Account::Trust_Account(std::string name, Money balance, double int_rate)
     : Savings_Account {name, balance, int_rate}, num_withdrawals {0}  {
         
 }
 
 // Deposit additional $50 bonus when amount >= $5000
-bool Trust_Account::deposit(double amount) {
-    if (amount >= bonus_threshold)
-        amount += bonus_amount;
-    return Savings_Account::deposit(amount);
+Expected<Money> Trust_Account::try_deposit(Money amount) {
+    Expected<Money> result = rules.deposit(balance, amount, int_rate);
+    if (result)
+        balance = result.value();
+    return result;
 }
     
 // Only allowed 3 withdrawals, each can be up to a maximum of 20% of the account's value
-void Trust_Account::withdraw(double amount) {
-    if (num_withdrawals >= max_withdrawals || (amount > balance * max_withdraw_percent))
-        throw IllegalTrustWithdrawalException();
-    else {
-        ++num_withdrawals;
-        Savings_Account::withdraw(amount);
-    }
+// (amount > 20% of balance, compared in whole cents as amount * 100 > balance * 20)
+Expected<Money> Trust_Account::try_withdraw(Money amount) {
+    Expected<Money> result = rules.withdraw(balance, num_withdrawals, amount);
+    if (result)
+        balance = result.value();
+    return result;
 }
 
-void Trust_Account::print(std::ostream &os) const {
-    os.precision(2);
-    os << std::fixed;
-    os << "[Trust Account: " << name << ": " << balance << ", " << int_rate 
-        << "%, withdrawals: " << num_withdrawals <<  "]";
+void Trust_Account::format(Print_Buffer &buffer) const {
+    buffer.append("[Trust Account: ").append(name).append(": ").append(balance).append(", ").append(int_rate)
+        .append("%, withdrawals: ").append(num_withdrawals).append(']');
 }
 
@@ -2,28 +2,34 @@
 #define _TRUST_ACCOUNT_H_
 
 #include "Savings_Account.h"
+#include "Account_Policy.h"
 #include "IllegalTrustWithdrawalException.h"
 
 class Trust_Account : public Savings_Account {
 private:
     static constexpr const char *def_name = "Unnamed Trust Account";
-    static constexpr double def_balance = 0.0;
+    static constexpr Money def_balance = 0.0;
     static constexpr double def_int_rate = 0.0;
-    static constexpr double bonus_amount = 50.0;
-    static constexpr double bonus_threshold = 5000.0;
+    static constexpr Money bonus_amount = 50.0;
+    static constexpr Money bonus_threshold = 5000.0;
     static constexpr int max_withdrawals = 3;
-    static constexpr double max_withdraw_percent = 0.2;
+    static constexpr int max_withdraw_percent = 20;
 protected:
     int num_withdrawals;
 public:
-    Trust_Account(std::string name = def_name,  double balance = def_balance, double int_rate = def_int_rate);
+    // The rules above as a row of the policy table, compiled at compile time
+    static constexpr Account_Policy policy {"Trust", true, bonus_threshold, bonus_amount, 0.0, max_withdrawals,
+                                            max_withdraw_percent};
+    static constexpr Compiled_Policy rules {policy};
+
+    Trust_Account(std::string name = def_name,  Money balance = def_balance, double int_rate = def_int_rate);
     
     // Deposits of $5000.00 or more will receive $50 bonus
-    virtual bool deposit(double amount) override;
+    virtual Expected<Money> try_deposit(Money amount) override;
     
     // Only allowed maximum of 3 withdrawals, each can be up to a maximum of 20% of the account's value
-    virtual void withdraw(double amount) override;
-    virtual void print(std::ostream &os) const override;
+    virtual Expected<Money> try_withdraw(Money amount) override;
+    virtual void format(Print_Buffer &buffer) const override;
 
     virtual ~Trust_Account() = default;
 };
@@ -0,0 +1,16 @@
+#ifndef __UNKNOWN_ACCOUNT_EXCEPTION_H__
+#define __UNKNOWN_ACCOUNT_EXCEPTION_H__
+#include <exception>
+
+class UnknownAccountException : public std::exception
+{
+public:
+    UnknownAccountException() noexcept = default;
+    ~UnknownAccountException() = default;
+
+    virtual const char *what() const noexcept override {
+        return "Unknown account";
+    }
+};
+
+#endif // __UNKNOWN_ACCOUNT_EXCEPTION_H__
@@ -72,7 +72,7 @@ int main() {
         cout << "Insert Number: ";
         cin >> balance_modifier;
         
-        double withdraw_amount {checking.get_balance() + balance_modifier};
+        double withdraw_amount {checking.get_balance().to_double() + balance_modifier};
 
         try{
             checking.withdraw(withdraw_amount);
@@ -92,7 +92,7 @@ int main() {
 
         // Special Testing for Trust
 
-        withdraw_amount = 0.5 * trust.get_balance();
+        withdraw_amount = 0.5 * trust.get_balance().to_double();
         try{
             trust.withdraw(withdraw_amount);
             successful_withdrawl(trust, withdraw_amount);
@@ -106,7 +106,7 @@ int main() {
         
 
         for (int i = 0; i < 4; i++){
-            withdraw_amount = 0.1 * trust.get_balance();
+            withdraw_amount = 0.1 * trust.get_balance().to_double();
             try{
                 trust.withdraw(withdraw_amount);
                 successful_withdrawl(trust, withdraw_amount);